@@ -9,8 +9,19 @@
 
 #include <string>
 #include <vector>
+#include <array>
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <atomic>
+
+#include "BoardGame_TT.h"
+#include "BoardGame_Symmetry.h"
 using namespace std;
 
 /////////////////////////////////////////////////////////////
@@ -19,155 +30,2041 @@ using namespace std;
 
 template <typename T> class Player;
 template <typename T> class Move;
+template <typename T> class MoveList;
+template <typename T> class MoveAgent;
 
 /////////////////////////////////////////////////////////////
 // Class declarations
 /////////////////////////////////////////////////////////////
 
 /**
- * @brief Represents the type of player in the game.
+ * @brief Represents the type of player in the game.
+ */
+enum class PlayerType {
+    HUMAN,     ///< A human player.
+    COMPUTER,  ///< A computer-controlled player.
+    AI,        ///< An AI player.
+    RANDOM     ///< A Random player.
+};
+
+/**
+ * @brief Mutable, non-owning row-major view of a board's cells.
+ *
+ * @tparam T Type of the elements stored in each cell.
+ *
+ * All cells live in a single buffer owned elsewhere (see FixedBoard and
+ * FixedGrid) and row @c x starts at @c x * stride. @c operator[] returns
+ * a lightweight row proxy, which keeps the familiar @c grid[x][y]
+ * indexing working.
+ */
+template <typename T>
+class Grid {
+    T* cells;        ///< First cell of the row-major buffer
+    int n_cells;     ///< Number of cells in the buffer
+    int stride;      ///< Distance between the starts of two rows
+
+public:
+    /** @brief Proxy for one row of a mutable grid. */
+    class Row {
+        T* first; ///< First cell of the row
+    public:
+        explicit Row(T* first) : first(first) {}
+        T& operator[](int y) const { return first[y]; }
+    };
+
+    /** @brief Proxy for one row of a read-only grid. */
+    class ConstRow {
+        const T* first; ///< First cell of the row
+    public:
+        explicit ConstRow(const T* first) : first(first) {}
+        const T& operator[](int y) const { return first[y]; }
+    };
+
+    /**
+     * @brief Construct a view of a rows x columns buffer starting at @p cells.
+     */
+    Grid(T* cells, int rows, int columns)
+        : cells(cells), n_cells(rows * columns), stride(columns) {}
+
+    /** @brief Point the view at another buffer of the same shape. */
+    void rebind(T* storage) { cells = storage; }
+
+    /** @brief Access row @p x. */
+    Row operator[](int x) { return Row(cells + x * stride); }
+
+    /** @brief Access row @p x of a read-only grid. */
+    ConstRow operator[](int x) const { return ConstRow(cells + x * stride); }
+
+    /** @brief Set every cell to @p value. */
+    void fill(const T& value) { std::fill(cells, cells + n_cells, value); }
+
+    /** @brief Pointer to the first cell of the row-major buffer. */
+    T* data() { return cells; }
+
+    /** @brief Pointer to the first cell of the row-major buffer. */
+    const T* data() const { return cells; }
+
+    /** @brief Total number of cells. */
+    int size() const { return n_cells; }
+
+    /** @brief Distance between the starts of two consecutive rows. */
+    int get_stride() const { return stride; }
+};
+
+//-----------------------------------------------------
+/**
+ * @brief Read-only, non-owning view of a board's cells.
+ *
+ * @tparam T Type of the elements stored on the board.
+ *
+ * A view is just a pointer into the board's storage plus its shape, so it
+ * can be passed to rendering and analysis code without copying the board.
+ * It stays valid only as long as the board it was taken from.
+ */
+template <typename T>
+class BoardView {
+    const T* cells; ///< First cell of the viewed storage
+    int rows;       ///< Number of rows
+    int columns;    ///< Number of columns
+    int stride;     ///< Distance between the starts of two rows
+
+public:
+    /**
+     * @brief Construct a view over row-major storage.
+     */
+    BoardView(const T* cells, int rows, int columns, int stride)
+        : cells(cells), rows(rows), columns(columns), stride(stride) {}
+
+    /** @brief Access row @p x; the result is indexed by column. */
+    typename Grid<T>::ConstRow operator[](int x) const {
+        return typename Grid<T>::ConstRow(cells + x * stride);
+    }
+
+    /** @brief Return content of cell x, y. */
+    const T& at(int x, int y) const { return cells[x * stride + y]; }
+
+    /** @brief Get number of rows. */
+    int get_rows() const { return rows; }
+
+    /** @brief Get number of columns. */
+    int get_columns() const { return columns; }
+
+    /** @brief Check whether the view covers no cells. */
+    bool empty() const { return rows == 0 || columns == 0; }
+};
+
+//-----------------------------------------------------
+/**
+ * @brief R x C grid of cells stored in place.
+ *
+ * @tparam T Type of the elements stored in each cell.
+ * @tparam R Number of rows.
+ * @tparam C Number of columns.
+ *
+ * A plain value type: it lives inside its owner, never allocates and is
+ * copied like an array. Used for side grids such as hidden boards.
+ */
+template <typename T, int R, int C>
+class FixedGrid {
+    array<T, R * C> cells; ///< Row-major cells
+
+public:
+    /** @brief Construct a grid with every cell set to @p value. */
+    explicit FixedGrid(const T& value = T()) { cells.fill(value); }
+
+    /** @brief Access row @p x. */
+    typename Grid<T>::Row operator[](int x) { return typename Grid<T>::Row(cells.data() + x * C); }
+
+    /** @brief Access row @p x of a read-only grid. */
+    typename Grid<T>::ConstRow operator[](int x) const {
+        return typename Grid<T>::ConstRow(cells.data() + x * C);
+    }
+
+    /** @brief Set every cell to @p value. */
+    void fill(const T& value) { cells.fill(value); }
+
+    /** @brief Pointer to the first cell of the row-major buffer. */
+    const T* data() const { return cells.data(); }
+
+    /** @brief Read-only view of the grid. */
+    BoardView<T> view() const { return BoardView<T>(cells.data(), R, C, C); }
+};
+
+//-----------------------------------------------------
+/**
+ * @brief Directions along which a LineTable generates lines.
+ */
+enum LineDirections : unsigned {
+    LINE_ROWS = 1,           ///< Left to right
+    LINE_COLUMNS = 2,        ///< Top to bottom
+    LINE_DIAGONALS = 4,      ///< Top left to bottom right
+    LINE_ANTI_DIAGONALS = 8, ///< Top right to bottom left
+    LINE_ALL = 15            ///< All four directions
+};
+
+/**
+ * @brief Call @p f(first, step) for every K-in-a-row line of an R x C board.
+ *
+ * A line covers the row-major cells first, first + step, ...,
+ * first + (K - 1) * step. Lines leaving the board or crossing a cell whose
+ * bit is clear in @p Mask are skipped.
+ */
+template <int R, int C, int K, unsigned Dirs, unsigned long long Mask, typename F>
+constexpr void for_each_line(F&& f) {
+    const int dx[4] = { 0, 1, 1, 1 };
+    const int dy[4] = { 1, 0, 1, -1 };
+    for (int d = 0; d < 4; ++d) {
+        if (!(Dirs & (1u << d)))
+            continue;
+        for (int x = 0; x < R; ++x)
+            for (int y = 0; y < C; ++y) {
+                bool fits = true;
+                for (int k = 0; k < K && fits; ++k) {
+                    int i = x + k * dx[d], j = y + k * dy[d];
+                    fits = i >= 0 && i < R && j >= 0 && j < C && ((Mask >> (i * C + j)) & 1);
+                }
+                if (fits)
+                    f(x * C + y, dx[d] * C + dy[d]);
+            }
+    }
+}
+
+/**
+ * @brief Number of lines for_each_line visits.
+ */
+template <int R, int C, int K, unsigned Dirs, unsigned long long Mask>
+constexpr int count_lines() {
+    int n = 0;
+    for_each_line<R, C, K, Dirs, Mask>([&](int, int) { ++n; });
+    return n;
+}
+
+/**
+ * @brief Cells of every line of a board, and the lines through every cell.
+ */
+template <int COUNT, int K, int CELLS>
+struct LineData {
+    unsigned char cells[COUNT][K]; ///< Row-major cells of each line
+    short first[CELLS + 1];        ///< Lines through cell i are through[first[i]] .. through[first[i + 1] - 1]
+    short through[COUNT * K];      ///< Line numbers grouped by cell
+};
+
+/**
+ * @brief Build the LineData visited by for_each_line.
+ */
+template <int R, int C, int K, unsigned Dirs, unsigned long long Mask, int COUNT>
+constexpr LineData<COUNT, K, R * C> build_lines() {
+    LineData<COUNT, K, R * C> data{};
+    int n = 0;
+    for_each_line<R, C, K, Dirs, Mask>([&](int first, int step) {
+        for (int k = 0; k < K; ++k)
+            data.cells[n][k] = static_cast<unsigned char>(first + k * step);
+        ++n;
+        });
+
+    // Count the lines through each cell, turn the counts into offsets,
+    // then file every line under its cells.
+    for (int line = 0; line < COUNT; ++line)
+        for (int k = 0; k < K; ++k)
+            ++data.first[data.cells[line][k] + 1];
+    for (int cell = 0; cell < R * C; ++cell)
+        data.first[cell + 1] += data.first[cell];
+    short next[R * C] = {};
+    for (int line = 0; line < COUNT; ++line)
+        for (int k = 0; k < K; ++k) {
+            int cell = data.cells[line][k];
+            data.through[data.first[cell] + next[cell]++] = static_cast<short>(line);
+        }
+    return data;
+}
+
+/**
+ * @brief Every K-in-a-row line of an R x C board, built at compile time.
+ *
+ * @tparam R Number of rows.
+ * @tparam C Number of columns.
+ * @tparam K Length of a line.
+ * @tparam Dirs LineDirections to generate lines along.
+ * @tparam Mask Bit x * C + y is set if cell (x, y) can hold a piece.
+ *
+ * The tables are constant data, so checking a board is a loop over small
+ * arrays of cell indices. Cells are addressed row-major with a stride of
+ * C, as in FixedBoard and FixedGrid.
+ */
+template <int R, int C, int K, unsigned Dirs = LINE_ALL, unsigned long long Mask = ~0ULL>
+struct LineTable {
+    static_assert(R * C <= 64, "LineTable cell masks hold at most 64 cells");
+
+    static constexpr int CELLS = R * C;                                ///< Number of cells
+    static constexpr int LENGTH = K;                                   ///< Cells per line
+    static constexpr int COUNT = count_lines<R, C, K, Dirs, Mask>();   ///< Number of lines
+    static_assert(COUNT > 0, "LineTable has no lines");
+
+    /// The lines and the lines through each cell.
+    static constexpr LineData<COUNT, K, CELLS> lines = build_lines<R, C, K, Dirs, Mask, COUNT>();
+
+    /** @brief Check whether every cell of @p line holds @p sym. */
+    template <typename T>
+    static bool complete(const T* cells, int line, const T& sym) {
+        for (int k = 0; k < K; ++k)
+            if (cells[lines.cells[line][k]] != sym)
+                return false;
+        return true;
+    }
+
+    /** @brief Check whether any line is filled with @p sym. */
+    template <typename T>
+    static bool any(const T* cells, const T& sym) {
+        for (int line = 0; line < COUNT; ++line)
+            if (complete(cells, line, sym))
+                return true;
+        return false;
+    }
+
+    /** @brief Check whether a line through @p cell is filled with @p sym. */
+    template <typename T>
+    static bool through(const T* cells, int cell, const T& sym) {
+        for (int i = lines.first[cell]; i < lines.first[cell + 1]; ++i)
+            if (complete(cells, lines.through[i], sym))
+                return true;
+        return false;
+    }
+
+    /** @brief Count the lines filled with @p sym. */
+    template <typename T>
+    static int count(const T* cells, const T& sym) {
+        int n = 0;
+        for (int line = 0; line < COUNT; ++line)
+            n += complete(cells, line, sym);
+        return n;
+    }
+};
+
+//-----------------------------------------------------
+/**
+ * @brief Advance @p state and return the next splitmix64 output.
+ */
+inline unsigned long long splitmix64(unsigned long long& state) {
+    unsigned long long z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Seedable xoshiro256** random number generator.
+ *
+ * One generator is meant to serve one game: it is injected into the board
+ * (for random events such as obstacles), the UI and the agents, so the same
+ * seed replays the same game bit for bit and parallel games never share
+ * state.
+ */
+class GameRandom {
+    unsigned long long state[4]; ///< Generator state
+
+    static unsigned long long rotl(unsigned long long x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    /** @brief Saved generator state: plain data, cheap to store and copy. */
+    struct State {
+        unsigned long long words[4]; ///< The four state words
+    };
+
+    /** @brief Construct a generator from @p seed. */
+    explicit GameRandom(unsigned long long seed = 0x853C49E6748FEA9BULL) { reseed(seed); }
+
+    /** @brief Restart the sequence from @p seed. */
+    void reseed(unsigned long long seed) {
+        for (unsigned long long& word : state)
+            word = splitmix64(seed);
+    }
+
+    /** @brief Next 64 random bits. */
+    unsigned long long next() {
+        unsigned long long result = rotl(state[1] * 5, 7) * 9;
+        unsigned long long t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    /** @brief Uniform random integer in [0, n). */
+    int below(int n) {
+        return static_cast<int>(((next() >> 32) * static_cast<unsigned>(n)) >> 32);
+    }
+
+    /** @brief Current state, for set_state to return to. */
+    State get_state() const {
+        State saved;
+        memcpy(saved.words, state, sizeof(state));
+        return saved;
+    }
+
+    /** @brief Return to a state saved by get_state. */
+    void set_state(const State& saved) { memcpy(state, saved.words, sizeof(state)); }
+};
+
+/**
+ * @brief Generator of the calling thread, used when none was injected.
+ */
+inline GameRandom& thread_random() {
+    thread_local GameRandom random;
+    return random;
+}
+
+//-----------------------------------------------------
+/**
+ * @brief Fixed table of random 64-bit keys used to hash board positions.
+ *
+ * Each board variant owns one table built from its own seed, so keys are
+ * reproducible from run to run. A cell has one key per symbol code
+ * (the symbol value modulo @c SYMBOLS) on each plane: plane 0 hashes the
+ * visible board, further planes hash hidden or ordering state. A few
+ * extra keys are left for counters and the side to move.
+ */
+class ZobristTable {
+public:
+    static const int SYMBOLS = 64;    ///< Distinct symbol codes per cell
+    static const int EXTRA_KEYS = 64; ///< Keys for variant-specific side state
+
+private:
+    int cells;                        ///< Number of cells per plane
+    vector<unsigned long long> keys;  ///< All keys, planes first then extras
+
+public:
+    /**
+     * @brief Build the table for a board of @p cells cells.
+     * @param cells Number of cells of the board.
+     * @param planes Number of cell planes to generate keys for.
+     * @param seed Variant-specific seed for the key generator.
+     */
+    ZobristTable(int cells, int planes, unsigned long long seed)
+        : cells(cells), keys(static_cast<size_t>(cells) * planes * SYMBOLS + EXTRA_KEYS + 1) {
+        for (unsigned long long& key : keys)
+            key = splitmix64(seed);
+    }
+
+    /** @brief Key of symbol code @p code on cell @p cell of plane @p plane. */
+    unsigned long long cell_key(int cell, unsigned code, int plane = 0) const {
+        return keys[(static_cast<size_t>(plane) * cells + cell) * SYMBOLS + code];
+    }
+
+    /** @brief Key @p i (0 <= i < EXTRA_KEYS) for variant-specific state. */
+    unsigned long long extra_key(int i) const {
+        return keys[keys.size() - 1 - EXTRA_KEYS + i];
+    }
+
+    /** @brief Key folded in when the second player is to move. */
+    unsigned long long side_key() const { return keys.back(); }
+};
+
+//-----------------------------------------------------
+/**
+ * @brief Non-owning view of a contiguous sequence, like C++20 std::span.
+ *
+ * @tparam T Element type; Span<const T> is a read-only view.
+ */
+template <typename T>
+class Span {
+    T* first;     ///< First element
+    size_t count; ///< Number of elements
+
+public:
+    /** @brief Construct an empty span. */
+    Span() : first(nullptr), count(0) {}
+
+    /** @brief View @p count elements starting at @p first. */
+    Span(T* first, size_t count) : first(first), count(count) {}
+
+    /** @brief View a whole array. */
+    template <size_t N>
+    Span(T (&elements)[N]) : first(elements), count(N) {}
+
+    /** @brief View the elements of a vector. */
+    template <typename U>
+    Span(vector<U>& elements) : first(elements.data()), count(elements.size()) {}
+
+    /** @brief View the elements of a read-only vector. */
+    template <typename U>
+    Span(const vector<U>& elements) : first(elements.data()), count(elements.size()) {}
+
+    /** @brief Read-only view of a mutable span. */
+    template <typename U>
+    Span(const Span<U>& other) : first(other.data()), count(other.size()) {}
+
+    T* data() const { return first; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    T& operator[](size_t i) const { return first[i]; }
+    T* begin() const { return first; }
+    T* end() const { return first + count; }
+};
+
+/**
+ * @brief Packs values of a few bits each into a byte buffer, low bits first.
+ *
+ * Writing past the end of the buffer is not an error at first: the bits
+ * are only counted, so a writer over an empty span measures how large an
+ * encoding is. ok() tells whether everything fitted.
+ */
+class BitWriter {
+    unsigned char* out; ///< Output buffer
+    size_t capacity;    ///< Size of the output buffer in bytes
+    size_t bits = 0;    ///< Bits written so far
+    bool failed = false; ///< Set by fail()
+
+public:
+    /** @brief Write into @p out. */
+    explicit BitWriter(Span<unsigned char> out) : out(out.data()), capacity(out.size()) {}
+
+    /** @brief Append the low @p n bits of @p value (n <= 64). */
+    void put(unsigned long long value, int n) {
+        while (n > 0) {
+            size_t byte = bits / 8;
+            int offset = static_cast<int>(bits % 8);
+            int take = min(8 - offset, n);
+            if (byte < capacity) {
+                unsigned char chunk = static_cast<unsigned char>((value & ((1u << take) - 1)) << offset);
+                out[byte] = offset ? static_cast<unsigned char>(out[byte] | chunk) : chunk;
+            }
+            value >>= take;
+            bits += take;
+            n -= take;
+        }
+    }
+
+    /** @brief Mark the encoding as invalid (e.g. a value has no code). */
+    void fail() { failed = true; }
+
+    /** @brief Bytes used so far, counting a partly filled last byte. */
+    size_t size() const { return (bits + 7) / 8; }
+
+    /** @brief Check that nothing failed and every byte fitted in the buffer. */
+    bool ok() const { return !failed && size() <= capacity; }
+};
+
+/**
+ * @brief Reads back values packed by BitWriter.
+ *
+ * Reading past the end yields zeros and clears ok(), so a decoder can read
+ * all its fields and check once before using them.
+ */
+class BitReader {
+    const unsigned char* in; ///< Input buffer
+    size_t capacity;         ///< Size of the input buffer in bytes
+    size_t bits = 0;         ///< Bits read so far
+    bool failed = false;     ///< Set on overrun or by fail()
+
+public:
+    /** @brief Read from @p in. */
+    explicit BitReader(Span<const unsigned char> in) : in(in.data()), capacity(in.size()) {}
+
+    /** @brief Read the next @p n bits (n <= 64). */
+    unsigned long long get(int n) {
+        unsigned long long value = 0;
+        for (int done = 0; done < n;) {
+            size_t byte = bits / 8;
+            int offset = static_cast<int>(bits % 8);
+            int take = min(8 - offset, n - done);
+            if (byte >= capacity) {
+                failed = true;
+                return 0;
+            }
+            value |= static_cast<unsigned long long>((in[byte] >> offset) & ((1u << take) - 1)) << done;
+            bits += take;
+            done += take;
+        }
+        return value;
+    }
+
+    /** @brief Mark the input as invalid (e.g. a field is out of range). */
+    void fail() { failed = true; }
+
+    /** @brief Pass over the next @p n bits without reading them. */
+    void skip(size_t n) { bits += n; }
+
+    /** @brief Bits left before the next byte boundary. */
+    int padding() const { return static_cast<int>((8 - bits % 8) % 8); }
+
+    /** @brief Bytes consumed so far, counting a partly read last byte. */
+    size_t size() const { return (bits + 7) / 8; }
+
+    /** @brief Check that every read was within the buffer and valid. */
+    bool ok() const { return !failed; }
+};
+
+/**
+ * @brief Symbols a board's cells can hold, in the order they are encoded.
+ *
+ * Snapshots store the index of each cell's symbol in just enough bits
+ * for @c size symbols. An empty alphabet makes them store cells whole.
+ */
+template <typename T>
+struct CellAlphabet {
+    const T* symbols = nullptr; ///< The symbols, indexed by code
+    int size = 0;               ///< Number of symbols
+
+    CellAlphabet() {}
+    CellAlphabet(const T* symbols, int size) : symbols(symbols), size(size) {}
+
+    /** @brief Bits needed per cell. */
+    int bits() const {
+        int n = 0;
+        while ((1 << n) < size) ++n;
+        return n;
+    }
+
+    /** @brief Code of @p symbol, or -1 if it is not in the alphabet. */
+    int code(const T& symbol) const {
+        for (int i = 0; i < size; ++i)
+            if (symbols[i] == symbol) return i;
+        return -1;
+    }
+};
+
+/**
+ * @brief Cells of a snapshot being restored, decoded on demand.
+ *
+ * Lets a board check its hidden state against the cells of a snapshot
+ * before anything is written. The codes must already be known to be in
+ * the alphabet.
+ */
+template <typename T>
+class SnapshotCells {
+    BitReader first;          ///< Reader positioned on the first cell
+    CellAlphabet<T> alphabet; ///< Symbols of the cells (empty: cells stored whole)
+    int bits;                 ///< Bits per cell
+    int columns;              ///< Cells per row
+
+public:
+    SnapshotCells(const BitReader& first, const CellAlphabet<T>& alphabet, int bits, int columns)
+        : first(first), alphabet(alphabet), bits(bits), columns(columns) {}
+
+    /** @brief Cell @p index, row-major. */
+    T at(int index) const {
+        BitReader reader = first;
+        reader.skip(static_cast<size_t>(index) * bits);
+        if (alphabet.size)
+            return alphabet.symbols[reader.get(bits)];
+        unsigned char raw[sizeof(T)];
+        for (size_t b = 0; b < sizeof(T); ++b)
+            raw[b] = static_cast<unsigned char>(reader.get(8));
+        T cell;
+        memcpy(&cell, raw, sizeof(T));
+        return cell;
+    }
+
+    /** @brief Cell (@p x, @p y). */
+    T at(int x, int y) const { return at(x * columns + y); }
+};
+
+//-----------------------------------------------------
+/**
+ * @brief Everything needed to take back one move made with Board::make_move.
+ *
+ * @tparam T Type of the elements stored on the board.
+ *
+ * The record lists each cell the move changed together with its previous
+ * content, the previous move count, and a few bits of variant-specific
+ * derived state packed by the board itself. If the move drew random
+ * events, it also keeps the generator's state from before the first draw.
+ */
+template <typename T>
+struct UndoRecord {
+    static const int MAX_CELLS = 12; ///< Most cells a single move may change
+
+    short n_cells;                ///< Number of changed cells
+    short cell[MAX_CELLS];        ///< Row-major index of each changed cell
+    T previous[MAX_CELLS];        ///< Content of each cell before the move
+    int n_moves;                  ///< Move count before the move
+    unsigned long long state;     ///< Variant-specific state before the move
+    unsigned long long hash;      ///< Position hash before the move
+    unsigned long long image_hash[SquareSymmetry::TRANSFORMS - 1]; ///< Hashes of the board's images before the move (symmetric boards)
+    int last_cell;                ///< Last-move cell before the move
+    GameRandom* generator;        ///< Generator the move drew from, nullptr if none
+    GameRandom::State generator_state; ///< State of @c generator before the move
+};
+
+/**
+ * @brief Stack of the undo records of a board.
+ *
+ * @tparam T Type of the elements stored on the board.
+ *
+ * The records live in one heap buffer, allocated by the first make_move,
+ * so a board that is never searched carries a pointer and a count, and
+ * copying a board copies no records: the history of a position is not
+ * part of it, so the copy's stack starts empty.
+ */
+template <typename T>
+class UndoStack {
+public:
+    static const int CAPACITY = 128; ///< Most records the stack holds
+
+private:
+    unique_ptr<UndoRecord<T>[]> records; ///< CAPACITY records, once allocated
+    int count = 0;                       ///< Number of records on the stack
+
+public:
+    UndoStack() {}
+    UndoStack(const UndoStack&) {}
+    UndoStack& operator=(const UndoStack&) {
+        count = 0;
+        return *this;
+    }
+
+    /** @brief Number of records on the stack. */
+    int size() const { return count; }
+
+    /** @brief Record just above the top, to fill before push. */
+    UndoRecord<T>& top_slot() {
+        if (!records)
+            records.reset(new UndoRecord<T>[CAPACITY]);
+        return records[count];
+    }
+
+    /** @brief Keep the record filled in top_slot. */
+    void push() { ++count; }
+
+    /** @brief Remove the top record and return it; the stack must not be empty. */
+    const UndoRecord<T>& pop() { return records[--count]; }
+
+    /** @brief Forget every record. */
+    void clear() { count = 0; }
+};
+
+//-----------------------------------------------------
+/**
+ * @brief Base template for any board used in board games.
+ *
+ * @tparam T Type of the elements stored on the board (e.g., char, int, string).
+ *
+ * Provides core data (rows, columns, matrix) and virtual methods to be
+ * implemented by specific games like Tic-Tac-Toe, Connect4, etc.
+ */
+template <typename T>
+class Board {
+public:
+    typedef T cell_type;             ///< Type of the elements stored on the board
+    static const int MAX_UNDO = UndoStack<T>::CAPACITY; ///< Deepest line make_move can record
+    static const int SNAPSHOT_VERSION = 1; ///< Format written by save_to
+
+protected:
+    int rows;        ///< Number of rows
+    int columns;     ///< Number of columns
+    Grid<T> board;   ///< Row-major cell storage for the board
+    int n_moves = 0; ///< Number of moves made
+    int last_cell = -1; ///< Row-major index of the last piece placed, -1 if unknown
+
+private:
+    UndoStack<T> undo_stack;                ///< Records of moves made with make_move
+    UndoRecord<T>* recording = nullptr;     ///< Record being filled, if any
+    const ZobristTable* zobrist = nullptr;  ///< Keys of this variant, if hashed
+    unsigned long long hash_key = 0;        ///< Hash of everything but the side to move
+    const SquareSymmetry* symmetry = nullptr; ///< Symmetries of the rules, if declared
+    unsigned long long image_hash[SquareSymmetry::TRANSFORMS - 1] = {}; ///< hash_key of the image under transforms 1 to 7
+    GameRandom* rng = nullptr;              ///< Generator for random events, if injected
+
+public:
+    /**
+     * @brief Construct a board with given dimensions over storage owned by
+     *        the derived class (see FixedBoard).
+     *
+     * @param cells First of rows * columns row-major cells; may be bound
+     *        later with Grid::rebind.
+     */
+    Board(int rows, int columns, T* cells)
+        : rows(rows), columns(columns), board(cells, rows, columns) {}
+
+    /**
+     * @brief Virtual destructor.
+     */
+    virtual ~Board() {}
+
+    /**
+     * @brief Heap copy of the board, for searches that run on several
+     *        threads at once.
+     *
+     * Returns nullptr unless the variant overrides it; such boards are
+     * searched on one thread.
+     */
+    virtual Board<T>* clone() const { return nullptr; }
+
+    /**
+     * @brief Update the board with a new move.
+     * @param move The move object containing position and symbol.
+     * @return true if the move is valid and applied, false otherwise.
+     */
+    virtual bool update_board(const Move<T>& move) = 0;
+
+    /** @brief Check if a player has won. */
+    virtual bool is_win(Player<T>*) = 0;
+
+    /** @brief Check if a player has lost. */
+    virtual bool is_lose(Player<T>*) = 0;
+
+    /** @brief Check if the game ended in a draw. */
+    virtual bool is_draw(Player<T>*) = 0;
+
+    /** @brief Check if the game is over. */
+    virtual bool game_is_over(Player<T>*) = 0;
+
+    /**
+     * @brief Play a move so that it can later be taken back with unmake_move.
+     *
+     * Behaves exactly like update_board, but also pushes an undo record on
+     * the board's fixed-size undo stack. Only the board's first call
+     * allocates, to set up the stack.
+     *
+     * @return true if the move is valid and applied, false otherwise
+     *         (also when the undo stack is full).
+     */
+    bool make_move(const Move<T>& move) {
+        if (undo_stack.size() == MAX_UNDO)
+            return false;
+
+        UndoRecord<T>& record = undo_stack.top_slot();
+        record.n_cells = 0;
+        record.n_moves = n_moves;
+        record.state = save_derived_state();
+        record.hash = hash_key;
+        if (symmetry)
+            memcpy(record.image_hash, image_hash, sizeof(image_hash));
+        record.last_cell = last_cell;
+        record.generator = nullptr;
+
+        recording = &record;
+        bool applied = update_board(move);
+        recording = nullptr;
+
+        if (!applied) {
+            rollback(record);
+            return false;
+        }
+        undo_stack.push();
+        return true;
+    }
+
+    /**
+     * @brief Take back the last move played with make_move.
+     *
+     * Restores every changed cell, the move count and all derived state,
+     * and rewinds the generator the move drew its random events from, so
+     * that searching on a board leaves the game's random events unchanged.
+     * With no move to take back it fails an assertion, and does nothing
+     * in release builds.
+     */
+    void unmake_move() {
+        assert(undo_stack.size() > 0 && "no move to take back");
+        if (undo_stack.size() == 0)
+            return;
+        rollback(undo_stack.pop());
+    }
+
+    /** @brief Number of moves that unmake_move can still take back. */
+    int get_undo_depth() const { return undo_stack.size(); }
+
+    /**
+     * @brief 64-bit Zobrist key of the current position.
+     *
+     * Covers every cell, the variant's hidden state and the side to move,
+     * and is kept up to date incrementally by update_board and unmake_move.
+     * Returns 0 for boards that do not set up a key table.
+     */
+    unsigned long long get_hash() const {
+        if (!zobrist) return 0;
+        return (n_moves % 2) ? hash_key ^ zobrist->side_key() : hash_key;
+    }
+
+    /** @brief Key table used by this board (nullptr if not hashed). */
+    const ZobristTable* get_zobrist_table() const { return zobrist; }
+
+    /**
+     * @brief Hash of the canonical representative of the position.
+     *
+     * On a board whose rules are symmetric under rotation and reflection
+     * (see init_symmetry) the board keeps the hash of each of its eight
+     * images up to date, and the canonical representative is the image
+     * with the least hash; all eight images of a position thus share one
+     * key, at the cost of a few comparisons. Other boards return get_hash().
+     *
+     * @param transform If given, receives the SquareSymmetry transform that
+     *        takes the board to its representative.
+     */
+    unsigned long long get_canonical_hash(int* transform = nullptr) const {
+        unsigned long long best = hash_key;
+        int best_transform = 0;
+        if (symmetry)
+            for (int t = 1; t < SquareSymmetry::TRANSFORMS; ++t)
+                if (image_hash[t - 1] < best) {
+                    best = image_hash[t - 1];
+                    best_transform = t;
+                }
+        if (transform) *transform = best_transform;
+        if (!zobrist) return 0;
+        return (n_moves % 2) ? best ^ zobrist->side_key() : best;
+    }
+
+    /** @brief Symmetries of the board's rules (nullptr if none are declared). */
+    const SquareSymmetry* get_symmetry() const { return symmetry; }
+
+    /**
+     * @brief Encode the position into @p out.
+     *
+     * Layout (version SNAPSHOT_VERSION): version, rows, columns and bits
+     * per cell (one byte each), the move count and the last-move cell plus
+     * one (16 bits each), every cell as its code in cell_alphabet(), then
+     * the variant's hidden state written by save_hidden, padded with zero
+     * bits to a whole byte. The undo stack is not saved.
+     *
+     * @return Bytes written, or 0 if @p out is too small or a cell holds a
+     *         symbol outside the alphabet.
+     */
+    size_t save_to(Span<unsigned char> out) const {
+        BitWriter writer(out);
+        write_snapshot(writer);
+        return writer.ok() ? writer.size() : 0;
+    }
+
+    /** @brief Bytes save_to needs for the current position. */
+    size_t snapshot_size() const {
+        BitWriter counter{ Span<unsigned char>() };
+        write_snapshot(counter);
+        return counter.size();
+    }
+
+    /**
+     * @brief Replace the position with one encoded by save_to.
+     *
+     * Nothing is allocated. The encoding is checked in full, hidden state
+     * included, before the board is touched, so on failure the board is
+     * unchanged. On success the undo stack is emptied and the hash
+     * recomputed.
+     *
+     * @return false if @p in is not a valid snapshot of this variant.
+     */
+    bool restore_from(Span<const unsigned char> in) {
+        BitReader reader(in);
+        CellAlphabet<T> alphabet = cell_alphabet();
+        int bits = alphabet.size ? alphabet.bits() : 8 * static_cast<int>(sizeof(T));
+        if (reader.get(8) != SNAPSHOT_VERSION || static_cast<int>(reader.get(8)) != rows ||
+            static_cast<int>(reader.get(8)) != columns || static_cast<int>(reader.get(8)) != bits)
+            return false;
+        int moves = static_cast<int>(reader.get(16));
+        int last = static_cast<int>(reader.get(16)) - 1;
+        if (!reader.ok() || last >= rows * columns)
+            return false;
+
+        // Check the cells, then let the variant read its hidden state and
+        // check it against them, then check the length; only then
+        // overwrite the cells and the hidden state.
+        SnapshotCells<T> cells(reader, alphabet, bits, columns);
+        for (int i = 0; i < rows * columns; ++i) {
+            unsigned long long code = reader.get(bits);
+            if (alphabet.size && code >= static_cast<unsigned long long>(alphabet.size))
+                return false;
+        }
+        unsigned long long hidden = 0;
+        if (!reader.ok() || !read_hidden(reader, cells, moves, hidden) ||
+            reader.get(reader.padding()) != 0 || !reader.ok() || reader.size() != in.size())
+            return false;
+
+        T* data = board.data();
+        for (int i = 0; i < rows * columns; ++i) {
+            data[i] = cells.at(i);
+            sync_cell(i);
+        }
+        n_moves = moves;
+        last_cell = last;
+        load_hidden(hidden);
+        undo_stack.clear();
+        rehash();
+        return true;
+    }
+
+    /**
+     * @brief Number of positions in the variant's perfect index, 0 if it
+     *        has none.
+     *
+     * Variants small enough to be solved outright number every position
+     * from 0 to position_count() - 1, so that tables such as tablebases
+     * (see BoardGame_Tablebase.h) can hold one entry per position.
+     */
+    virtual long long position_count() const { return 0; }
+
+    /** @brief Index of the current position, -1 if the variant has no index. */
+    virtual long long position_index() const { return -1; }
+
+    /**
+     * @brief Replace the position with the one numbered @p index.
+     *
+     * On success the undo stack is emptied, the last move forgotten and the
+     * hash recomputed, as by restore_from.
+     *
+     * @return false (board unchanged) if the variant has no index or
+     *         @p index does not number a position.
+     */
+    virtual bool set_position(long long) { return false; }
+
+    /**
+     * @brief Draw the board's random events from @p random.
+     *
+     * Without an injected generator the calling thread's one is used.
+     */
+    void set_random(GameRandom* random) { rng = random; }
+
+    /**
+     * @brief List every move the player may legally play right now.
+     * @param player The player to move.
+     * @param moves Receives the moves; it is cleared first.
+     */
+    virtual void generate_moves(Player<T>* player, MoveList<T>& moves) = 0;
+
+    /**
+     * @brief Heuristic score of the position for @p player, who just moved.
+     *
+     * Used by searches where their depth runs out; higher is better for
+     * @p player and the score must stay within +-100000, well below a win.
+     * The default knows nothing and scores every position 0.
+     */
+    virtual int evaluate(Player<T>*) { return 0; }
+
+    /**
+     * @brief Return a copy of the current board as a 2D vector.
+     */
+    vector<vector<T>> get_board_matrix() const {
+        vector<vector<T>> matrix(rows);
+        for (int i = 0; i < rows; ++i) {
+            const T* row = board.data() + i * board.get_stride();
+            matrix[i].assign(row, row + columns);
+        }
+        return matrix;
+    }
+
+    /**
+     * @brief Return a read-only view of the board without copying it.
+     */
+    BoardView<T> view() const {
+        return BoardView<T>(board.data(), rows, columns, board.get_stride());
+    }
+
+    /** @brief Get number of rows. */
+    int get_rows() const { return rows; }
+
+    /** @brief Get number of columns. */
+    int get_columns() const { return columns; }
+
+    /** @brief Get number of moves. */
+    int get_n_moves() const { return n_moves; }
+
+    /** @brief Return content of cell x, y in current board. */
+    T get_cell(int x, int y) {
+        return board[x][y];
+    }
+
+protected:
+    /**
+     * @brief Write a cell, logging its old content when inside make_move.
+     *
+     * Boards must change cells through this function in update_board so
+     * that unmake_move can restore them. A move may change at most
+     * UndoRecord::MAX_CELLS cells; one that changes more could not be
+     * taken back, and fails an assertion.
+     */
+    void set_cell(int x, int y, const T& value) {
+        T& cell = board[x][y];
+        int index = x * board.get_stride() + y;
+        if (recording) {
+            assert(recording->n_cells < UndoRecord<T>::MAX_CELLS && "move changes too many cells to undo");
+            if (recording->n_cells < UndoRecord<T>::MAX_CELLS) {
+                recording->cell[recording->n_cells] = static_cast<short>(index);
+                recording->previous[recording->n_cells] = cell;
+                ++recording->n_cells;
+            }
+        }
+        if (zobrist) {
+            unsigned from = symbol_code(cell), to = symbol_code(value);
+            hash_key ^= zobrist->cell_key(index, from) ^ zobrist->cell_key(index, to);
+            if (symmetry)
+                for (int t = 1; t < SquareSymmetry::TRANSFORMS; ++t) {
+                    int image = symmetry->map(t, index);
+                    image_hash[t - 1] ^= zobrist->cell_key(image, from) ^ zobrist->cell_key(image, to);
+                }
+        }
+        cell = value;
+    }
+
+    /**
+     * @brief Start hashing the board with @p table.
+     *
+     * Called once at the end of a variant's constructor, after the initial
+     * cells are set.
+     */
+    void init_hash(const ZobristTable& table) {
+        zobrist = &table;
+        rehash();
+    }
+
+    /**
+     * @brief Declare the rules symmetric under the eight rotations and
+     *        reflections of the square, so that get_canonical_hash maps
+     *        all images of a position to one key.
+     *
+     * Called in the constructor of a square board, after init_hash;
+     * ignored on other boards. The variant's hidden state must then be
+     * hashed per cell, through image_cell in derived_hash.
+     */
+    void init_symmetry(const SquareSymmetry& table) {
+        if (table.get_side() != rows || rows != columns || board.get_stride() != columns)
+            return;
+        symmetry = &table;
+        rehash();
+    }
+
+    /** @brief Recompute the hash from scratch after a bulk change. */
+    void rehash() {
+        if (!zobrist) return;
+        hash_key = derived_hash(0);
+        for (int i = 0; i < board.size(); ++i)
+            hash_key ^= zobrist->cell_key(i, symbol_code(board.data()[i]));
+        if (symmetry)
+            for (int t = 1; t < SquareSymmetry::TRANSFORMS; ++t) {
+                unsigned long long key = derived_hash(t);
+                for (int i = 0; i < board.size(); ++i)
+                    key ^= zobrist->cell_key(symmetry->map(t, i), symbol_code(board.data()[i]));
+                image_hash[t - 1] = key;
+            }
+    }
+
+    /**
+     * @brief Finish set_position once the variant has written the cells
+     *        (directly) and its hidden state: set the move count, forget
+     *        the last move and the undo stack, and recompute the hash.
+     */
+    void load_position(int moves) {
+        for (int i = 0; i < rows * columns; ++i)
+            sync_cell(i);
+        n_moves = moves;
+        last_cell = -1;
+        undo_stack.clear();
+        rehash();
+    }
+
+    /**
+     * @brief Cell @p cell (row-major) of the board's image under transform
+     *        @p transform; @p cell itself on boards without symmetry.
+     */
+    int image_cell(int transform, int cell) const {
+        return symmetry ? symmetry->map(transform, cell) : cell;
+    }
+
+    /**
+     * @brief Generator for the board's random events.
+     *
+     * Inside make_move the generator's state is saved on first use, for
+     * unmake_move to restore.
+     */
+    GameRandom& random() {
+        GameRandom& generator = rng ? *rng : thread_random();
+        if (recording && !recording->generator) {
+            recording->generator = &generator;
+            recording->generator_state = generator.get_state();
+        }
+        return generator;
+    }
+
+    /** @brief Flip @p key in or out of the hash (for derived state). */
+    void toggle_hash(unsigned long long key) { hash_key ^= key; }
+
+    /**
+     * @brief Flip the key of @p code on hidden-state cell @p cell of plane
+     *        @p plane of @p keys in or out of the hash and of every image's.
+     */
+    void toggle_cell_key(const ZobristTable& keys, int cell, unsigned code, int plane) {
+        hash_key ^= keys.cell_key(cell, code, plane);
+        if (symmetry)
+            for (int t = 1; t < SquareSymmetry::TRANSFORMS; ++t)
+                image_hash[t - 1] ^= keys.cell_key(symmetry->map(t, cell), code, plane);
+    }
+
+    /**
+     * @brief Flip derived_hash in or out of the hash and of every image's.
+     *
+     * Calling it before and after changing hidden state brings the hash
+     * up to date however much of the state changed.
+     */
+    void toggle_derived_hash() {
+        hash_key ^= derived_hash(0);
+        if (symmetry)
+            for (int t = 1; t < SquareSymmetry::TRANSFORMS; ++t)
+                image_hash[t - 1] ^= derived_hash(t);
+    }
+
+    /**
+     * @brief Hash of the state that is not stored in the cells, as seen in
+     *        the board's image under @p transform (0: the board itself).
+     *
+     * Variants with hidden state override this; update_board keeps the
+     * same contribution current with toggle_hash, toggle_cell_key or
+     * toggle_derived_hash. Only symmetric boards are asked for other
+     * transforms than 0; they key cells through image_cell.
+     */
+    virtual unsigned long long derived_hash(int) const { return 0; }
+
+    /** @brief Zobrist symbol code of a cell value. */
+    static unsigned symbol_code(const T& value) {
+        return static_cast<unsigned char>(value) % ZobristTable::SYMBOLS;
+    }
+
+    /**
+     * @brief Pack any state that is not stored in the cells (counters,
+     *        queues, used symbols) into 64 bits before a move is made.
+     */
+    virtual unsigned long long save_derived_state() const { return 0; }
+
+    /**
+     * @brief Restore state packed by save_derived_state.
+     *
+     * Called by unmake_move after the cells and move count are restored.
+     */
+    virtual void restore_derived_state(unsigned long long) {}
+
+    /**
+     * @brief Called after cell @p index (row-major) was written without
+     *        set_cell, by unmake_move or restore_from.
+     *
+     * Boards that mirror their cells in other structures (such as
+     * bitboards) bring them up to date here.
+     */
+    virtual void sync_cell(int) {}
+
+    /** @brief Symbols the cells can hold, for snapshots (empty: store cells whole). */
+    virtual CellAlphabet<T> cell_alphabet() const { return CellAlphabet<T>(); }
+
+    /**
+     * @brief Append the state that is not stored in the cells to a snapshot.
+     */
+    virtual void save_hidden(BitWriter&) const {}
+
+    /**
+     * @brief Read back the state written by save_hidden, without changing
+     *        the board.
+     *
+     * @p cells and @p moves describe the position being restored, so that
+     * the state can be checked against them. The state is packed into
+     * @p hidden for load_hidden, which restore_from calls only once the
+     * whole snapshot is known to be valid.
+     *
+     * @return false if the data is invalid or contradicts the position.
+     */
+    virtual bool read_hidden(BitReader&, const SnapshotCells<T>&, int, unsigned long long&) const {
+        return true;
+    }
+
+    /**
+     * @brief Set the hidden state packed by read_hidden. Called by
+     *        restore_from after the cells and move count are restored.
+     */
+    virtual void load_hidden(unsigned long long) {}
+
+    /**
+     * @brief Remember (x, y) as the cell the current move put a piece on.
+     *
+     * Line checks use it to look only at the lines through the last move.
+     */
+    void set_last_move(int x, int y) { last_cell = x * board.get_stride() + y; }
+
+    /**
+     * @brief Check whether @p sym fills one of the lines of @p Lines on @p cells.
+     *
+     * Games end on the first completed line and a move can only complete
+     * lines through the piece it placed, so once a last move is known only
+     * the lines through it are examined. Removals and obstacles never
+     * complete a line and need no rescan. Without a last move (a fresh
+     * board) every line is examined.
+     *
+     * @tparam Lines LineTable of the board's shape.
+     * @param cells Row-major cells with the board's dimensions.
+     */
+    template <typename Lines>
+    bool has_line(const T* cells, const T& sym) const {
+        if (last_cell >= 0)
+            return cells[last_cell] == sym && Lines::through(cells, last_cell, sym);
+        return Lines::any(cells, sym);
+    }
+
+    /** @brief has_line on the board's own cells. */
+    template <typename Lines>
+    bool has_line(const T& sym) const { return has_line<Lines>(board.data(), sym); }
+
+    /**
+     * @brief Add a placement of @p symbol on every cell that holds @p empty.
+     */
+    void list_empty_cells(const T& empty, const T& symbol, MoveList<T>& moves) const {
+        moves.clear();
+        for (int i = 0; i < rows; ++i)
+            for (int j = 0; j < columns; ++j)
+                if (board[i][j] == empty)
+                    moves.add(Move<T>(i, j, symbol));
+    }
+
+private:
+    /** @brief Write the snapshot described in save_to. */
+    void write_snapshot(BitWriter& writer) const {
+        CellAlphabet<T> alphabet = cell_alphabet();
+        int bits = alphabet.size ? alphabet.bits() : 8 * static_cast<int>(sizeof(T));
+        writer.put(SNAPSHOT_VERSION, 8);
+        writer.put(rows, 8);
+        writer.put(columns, 8);
+        writer.put(bits, 8);
+        writer.put(n_moves, 16);
+        writer.put(last_cell + 1, 16);
+
+        const T* data = board.data();
+        for (int i = 0; i < rows * columns; ++i) {
+            if (alphabet.size) {
+                int code = alphabet.code(data[i]);
+                if (code < 0) writer.fail();
+                writer.put(code < 0 ? 0 : code, bits);
+            }
+            else {
+                unsigned char raw[sizeof(T)];
+                memcpy(raw, &data[i], sizeof(T));
+                for (size_t b = 0; b < sizeof(T); ++b)
+                    writer.put(raw[b], 8);
+            }
+        }
+        save_hidden(writer);
+    }
+
+    /** @brief Undo everything a record describes. */
+    void rollback(const UndoRecord<T>& record) {
+        for (int i = record.n_cells - 1; i >= 0; --i) {
+            board.data()[record.cell[i]] = record.previous[i];
+            sync_cell(record.cell[i]);
+        }
+        n_moves = record.n_moves;
+        hash_key = record.hash;
+        if (symmetry)
+            memcpy(image_hash, record.image_hash, sizeof(image_hash));
+        last_cell = record.last_cell;
+        if (record.generator)
+            record.generator->set_state(record.generator_state);
+        restore_derived_state(record.state);
+    }
+};
+
+//-----------------------------------------------------
+/**
+ * @brief Board whose R x C cells are stored in place.
+ *
+ * @tparam T Type of the elements stored on the board.
+ * @tparam R Number of rows.
+ * @tparam C Number of columns.
+ *
+ * The dimensions are compile-time constants and the cells live in a
+ * std::array inside the object, so a board can live on the stack and only
+ * touches the heap to set up its undo stack, the first time it is
+ * searched. Copying a board copies its cells and rebinds the base Grid to
+ * the copy's own array; the copy's undo stack starts empty.
+ */
+template <typename T, int R, int C>
+class FixedBoard : public Board<T> {
+public:
+    static constexpr int ROWS = R;        ///< Number of rows
+    static constexpr int COLUMNS = C;     ///< Number of columns
+    static constexpr int CELLS = R * C;   ///< Number of cells
+
+private:
+    array<T, R * C> storage; ///< Row-major cells viewed by Board::board
+
+public:
+    FixedBoard() : Board<T>(R, C, nullptr) { this->board.rebind(storage.data()); }
+
+    FixedBoard(const FixedBoard& other) : Board<T>(other), storage(other.storage) {
+        this->board.rebind(storage.data());
+    }
+
+    FixedBoard& operator=(const FixedBoard& other) {
+        Board<T>::operator=(other);
+        storage = other.storage;
+        this->board.rebind(storage.data());
+        return *this;
+    }
+};
+
+//-----------------------------------------------------
+/**
+ * @brief Represents a single move in a board game.
+ *
+ * @tparam T Type of symbol placed on the board (e.g., char, int).
+ *
+ * Moves are small value types: they are returned and passed by value,
+ * so playing a move never touches the heap. Sliding games store the
+ * direction of travel in the same object (0 when the move has none).
+ */
+template <typename T>
+class Move {
+    int x;          ///< Row index
+    int y;          ///< Column index
+    T symbol;       ///< Symbol used in the move
+    char direction; ///< Direction for sliding moves ('L','R','U','D'), 0 otherwise
+
+public:
+    /** @brief Construct an empty move that no board accepts. */
+    Move() : x(-1), y(-1), symbol(), direction(0) {}
+
+    /** @brief Construct a move at (x, y) using a symbol. */
+    Move(int x, int y, T symbol, char direction = 0)
+        : x(x), y(y), symbol(symbol), direction(direction) {}
+
+
+    /** @brief Get row index. */
+    int get_x() const { return x; }
+
+    /** @brief Get column index. */
+    int get_y() const { return y; }
+
+    /** @brief Get the move symbol. */
+    T get_symbol() const { return symbol; }
+
+    /** @brief Get the direction of a sliding move (0 if none). */
+    char get_direction() const { return direction; }
+
+};
+
+//-----------------------------------------------------
+/**
+ * @brief Fixed-capacity list of moves filled by Board<T>::generate_moves.
+ *
+ * @tparam T Type of symbol used by the moves.
+ *
+ * The storage is an in-place array, so a list can live on the stack and
+ * be refilled every ply without any heap allocation.
+ */
+template <typename T>
+class MoveList {
+public:
+    static const int CAPACITY = 361; ///< Largest number of moves any board can list (19x19)
+
+private:
+    Move<T> moves[CAPACITY]; ///< Listed moves
+    int count = 0;           ///< Number of listed moves
+
+public:
+    /** @brief Remove every move from the list. */
+    void clear() { count = 0; }
+
+    /** @brief Append a move; moves beyond @c CAPACITY are dropped. */
+    void add(const Move<T>& move) {
+        if (count < CAPACITY)
+            moves[count++] = move;
+    }
+
+    /** @brief Number of moves in the list. */
+    int size() const { return count; }
+
+    /** @brief Check whether the list holds no moves. */
+    bool empty() const { return count == 0; }
+
+    /** @brief Access move @p i. */
+    const Move<T>& operator[](int i) const { return moves[i]; }
+
+    const Move<T>* begin() const { return moves; }
+    const Move<T>* end() const { return moves + count; }
+};
+
+//-----------------------------------------------------
+/**
+ * @brief Base template for all players (human or AI).
+ *
+ * @tparam T Type of symbol used by the player.
+ */
+template <typename T>
+class Player {
+protected:
+    string name;         ///< Player name
+    PlayerType type;     ///< Player type (e.g., HUMAN or COMPUTER)
+    T symbol;            ///< Players symbol on board
+    Board<T>* boardPtr;  ///< Pointer to the game board
+    unique_ptr<MoveAgent<T>> agent; ///< Chooses the moves of a computer player
+
+public:
+    /**
+     * @brief Construct a player with name, symbol, and type.
+     */
+    Player(string n, T s, PlayerType t)
+        : name(n), symbol(s), type(t), boardPtr(nullptr) {}
+
+    virtual ~Player() {}
+
+    /** @brief Get the player's name. */
+    string get_name() const { return name; }
+
+    /** @brief Get player type (e.g., 'H' or 'C'). */
+    PlayerType get_type() const { return type; }
+
+    /** @brief Get the player's symbol. */
+    T get_symbol() const { return symbol; }
+
+    /** @brief Get a pointer to the game board. */
+    Board<T>* get_board_ptr() const { return boardPtr; }
+
+    /** @brief Assign the board pointer for the player. */
+    void set_board_ptr(Board<T>* b) { boardPtr = b; }
+
+    /** @brief Let @p a choose this player's moves; the player takes ownership. */
+    void set_agent(MoveAgent<T>* a) { agent.reset(a); }
+
+    /** @brief Agent choosing this player's moves (nullptr for a human). */
+    MoveAgent<T>* get_agent() const { return agent.get(); }
+};
+
+//-----------------------------------------------------
+/**
+ * @brief Limits on the work an agent may spend choosing one move.
+ *
+ * A limit of 0 means none. Agents that do not search ignore the budget.
  */
-enum class PlayerType {
-    HUMAN,     ///< A human player.
-    COMPUTER,  ///< A computer-controlled player.
-    AI,        ///< An AI player.
-    RANDOM     ///< A Random player.
+struct MoveBudget {
+    int depth = 0;        ///< Deepest ply to look ahead
+    long long nodes = 0;  ///< Most positions to visit (playouts for Monte Carlo agents)
+    long long millis = 0; ///< Wall-clock time allowed, in milliseconds
 };
 
 /**
- * @brief Base template for any board used in board games.
+ * @brief Source of moves for a computer player.
  *
- * @tparam T Type of the elements stored on the board (e.g., char, int, string).
+ * @tparam T Type of symbol used on the board.
  *
- * Provides core data (rows, columns, matrix) and virtual methods to be
- * implemented by specific games like Tic-Tac-Toe, Connect4, etc.
+ * Agents work on any variant through the Board interface, so one engine
+ * serves every game. They may play moves on the board while thinking
+ * (with make_move) but leave it as they found it.
  */
 template <typename T>
-class Board {
+class MoveAgent {
 protected:
-    int rows;        ///< Number of rows
-    int columns;     ///< Number of columns
-    vector<vector<T>> board; ///< 2D vector for the board
-    int n_moves = 0; ///< Number of moves made
+    MoveBudget budget; ///< Budget of the two-argument choose_move
 
 public:
+    virtual ~MoveAgent() {}
+
     /**
-     * @brief Construct a board with given dimensions.
+     * @brief Choose the next move of @p player on @p board within @p budget.
      */
-    Board(int rows, int columns)
-        : rows(rows), columns(columns), board(rows, vector<T>(columns)) {}
+    virtual Move<T> choose_move(Board<T>& board, Player<T>* player, const MoveBudget& budget) = 0;
+
+    /** @brief Choose the next move of @p player within the agent's own budget. */
+    Move<T> choose_move(Board<T>& board, Player<T>* player) {
+        return choose_move(board, player, budget);
+    }
+
+    /** @brief Set the budget used when none is passed to choose_move. */
+    void set_budget(const MoveBudget& b) { budget = b; }
+
+    /** @brief Budget used when none is passed to choose_move. */
+    const MoveBudget& get_budget() const { return budget; }
+};
+
+/**
+ * @brief Agent that plays a uniformly random legal move.
+ *
+ * Returns an empty move (rejected by every board) if the player has
+ * no legal move.
+ */
+template <typename T>
+class RandomAgent final : public MoveAgent<T> {
+    GameRandom* random; ///< Generator to draw from (nullptr: the thread's)
+
+    template <typename BoardT>
+    Move<T> pick(BoardT& board, Player<T>* player) {
+        MoveList<T> moves;
+        board.generate_moves(player, moves);
+        if (moves.empty())
+            return Move<T>(-1, -1, player->get_symbol());
+        return moves[(random ? *random : thread_random()).below(moves.size())];
+    }
+
+public:
+    /** @brief Construct an agent drawing from @p random. */
+    explicit RandomAgent(GameRandom* random = nullptr) : random(random) {}
+
+    Move<T> choose_move(Board<T>& board, Player<T>* player, const MoveBudget&) override {
+        return pick(board, player);
+    }
 
     /**
-     * @brief Virtual destructor. Frees allocated board memory.
+     * @brief choose_move for a board whose concrete type is known, so that
+     *        move generation is resolved at compile time.
      */
-    virtual ~Board() {}
+    template <typename BoardT>
+    Move<T> choose_move(BoardT& board, Player<T>* player) {
+        return pick(board, player);
+    }
+};
+
+/**
+ * @brief Result of a search by NegamaxSearch.
+ *
+ * @tparam T Type of symbol used on the board.
+ */
+template <typename T>
+struct SearchResult {
+    Move<T> move;        ///< Best move found (empty if the side to move had none)
+    int score = 0;       ///< Score of the move for the side to move
+    long long nodes = 0; ///< Positions visited
+    int depth = 0;       ///< Deepest iteration completed (0 if the search does not deepen)
+};
+
+/**
+ * @brief Negamax search with alpha-beta pruning and principal variation
+ *        search, usable on every variant.
+ *
+ * @tparam T Type of symbol used on the board.
+ *
+ * The engine only needs what every Board provides: generate_moves,
+ * make_move and unmake_move to walk the tree, is_win, is_lose and is_draw
+ * (asked of the player who just moved, exactly as GameManager ends a
+ * game) to recognise the end of a game, and evaluate to score the
+ * positions where the depth runs out. Wins score WIN_SCORE minus the
+ * number of plies they take, so the quickest win and the slowest loss are
+ * preferred.
+ *
+ * The search deepens one ply at a time, starting with the best move of
+ * the previous iteration, until the budget's depth, nodes or time run
+ * out, the game is solved, or stop is called. A search cut short returns
+ * the best move of the last iteration it completed, or the move the
+ * unfinished one found better than that, so there is always a legal move
+ * to play however small the budget. The time budget does not apply until
+ * the first iteration is complete, so even a 1 ms search plays a searched
+ * move; after that the clock is read before every root move and every 8
+ * positions below, and the recursion unwinds through make/unmake as
+ * usual, so the board is left as it was. To answer within the time
+ * budget in spite of that, the search stops a tenth of it early. The
+ * moves of each ply are listed in frames the engine keeps on the heap, so
+ * deep lines on big boards do not use up the thread's stack.
+ *
+ * The first move of each node is searched with the full window and the
+ * others with a null window, re-searched only if they turn out better.
+ * A move that caused a cut-off is remembered per ply, across iterations,
+ * and tried first at the next node of that ply.
+ *
+ * Given a TranspositionTable (set_table) and a hashed board, every node
+ * first looks its position up: a deep enough entry whose bound settles
+ * the window returns at once, and otherwise its best move is tried
+ * first, which carries each iteration's ordering into the next. Positions
+ * are keyed by Board::get_canonical_hash, so on symmetric boards the
+ * rotations and reflections of a position share one entry. Scores of
+ * subtrees searched to the end of the game are stored at SOLVED_DEPTH,
+ * good for any depth; nothing is stored once the search is cut short.
+ * The table may be shared with other searches, in other threads too.
+ */
+template <typename T>
+class NegamaxSearch {
+public:
+    static const int WIN_SCORE = 1000000;           ///< Score of winning with the next move
+    static const int INFINITE_SCORE = WIN_SCORE + 1; ///< Bound beyond every score
+    static const int MAX_PLY = Board<T>::MAX_UNDO;  ///< Deepest line the board can take back
+    static const int SOLVED_DEPTH = 255;            ///< Table depth of subtrees searched to the end
+
+private:
+    long long nodes = 0;        ///< Positions visited by the current search
+    long long max_nodes = 0;    ///< Node budget of the current search (0: none)
+    bool timed = false;         ///< Whether the deadline of the current search applies yet
+    chrono::steady_clock::time_point deadline; ///< End of the time budget
+    bool stopped = false;       ///< Set when the current search runs out of budget
+    atomic<bool> stop_requested{ false }; ///< Set by stop
+    bool horizon = false;       ///< Whether the current subtree was cut by the depth
+    Move<T> killers[MAX_PLY];   ///< Last move that caused a cut-off at each ply
+    bool has_killer[MAX_PLY] = {}; ///< Whether killers[ply] is set
+    TranspositionTable* table = nullptr; ///< Shared position cache (nullptr: none)
+    TTStats table_stats;        ///< Table counters of the current search
+    bool hashed = false;        ///< Whether the current search uses the table
+
+    /** @brief Moves of the position at one ply, in search order. */
+    struct Frame {
+        MoveList<T> moves;                           ///< Legal moves
+        const Move<T>* order[MoveList<T>::CAPACITY]; ///< Moves in the order they are searched
+    };
+    vector<unique_ptr<Frame>> frames; ///< Frame of each ply reached so far, kept between searches
+
+    /** @brief Frame of @p ply, allocated the first time the ply is reached. */
+    Frame& frame(int ply) {
+        while (static_cast<int>(frames.size()) <= ply)
+            frames.emplace_back(new Frame);
+        return *frames[ply];
+    }
+
+    static bool same_move(const Move<T>& a, const Move<T>& b) {
+        return a.get_x() == b.get_x() && a.get_y() == b.get_y() &&
+               a.get_symbol() == b.get_symbol() && a.get_direction() == b.get_direction();
+    }
 
     /**
-     * @brief Update the board with a new move.
-     * @param move The move object containing position and symbol.
-     * @return true if the move is valid and applied, false otherwise.
+     * @brief Point @p order at @p moves, move @p first (an index, -1 for
+     *        none) first and the killer of @p ply next; returns the count.
      */
-    virtual bool update_board(Move<T>* move) = 0;
+    int order_moves(const MoveList<T>& moves, int ply, const Move<T>** order, int first = -1) const {
+        int n = moves.size();
+        for (int i = 0; i < n; ++i)
+            order[i] = &moves[i];
+        int front = 0;
+        if (first >= 0 && first < n) {
+            swap(order[0], order[first]);
+            front = 1;
+        }
+        if (has_killer[ply])
+            for (int i = front; i < n; ++i)
+                if (same_move(*order[i], killers[ply])) {
+                    swap(order[front], order[i]);
+                    break;
+                }
+        return n;
+    }
 
-    /** @brief Check if a player has won. */
-    virtual bool is_win(Player<T>*) = 0;
+    /**
+     * @brief Table form of move @p i of @p moves, or -1 if none fits.
+     *
+     * On boards without symmetry this is the index itself. On symmetric
+     * boards, whose table key is the canonical hash, it is the move's cell
+     * in the canonical image (reached with @p transform) plus the number
+     * of board cells times the move's rank among the moves on its cell,
+     * which every image of the position agrees on.
+     */
+    template <typename BoardT>
+    static int to_hint(const BoardT& board, const MoveList<T>& moves, int i, int transform) {
+        const SquareSymmetry* symmetry = board.get_symmetry();
+        if (!symmetry || i < 0) return i;
+        int rank = 0;
+        for (int j = 0; j < i; ++j)
+            if (moves[j].get_x() == moves[i].get_x() && moves[j].get_y() == moves[i].get_y())
+                ++rank;
+        int cell = moves[i].get_x() * board.get_columns() + moves[i].get_y();
+        int hint = rank * board.get_rows() * board.get_columns() + symmetry->map(transform, cell);
+        return hint <= TranspositionTable::MAX_MOVE ? hint : -1;
+    }
 
-    /** @brief Check if a player has lost. */
-    virtual bool is_lose(Player<T>*) = 0;
+    /** @brief Index in @p moves of the move stored as @p hint by to_hint, or -1. */
+    template <typename BoardT>
+    static int from_hint(const BoardT& board, const MoveList<T>& moves, int hint, int transform) {
+        const SquareSymmetry* symmetry = board.get_symmetry();
+        if (!symmetry || hint < 0) return hint;
+        int cells = board.get_rows() * board.get_columns();
+        int cell = symmetry->map(symmetry->inverse(transform), hint % cells);
+        int rank = hint / cells;
+        for (int j = 0; j < moves.size(); ++j)
+            if (moves[j].get_x() * board.get_columns() + moves[j].get_y() == cell && rank-- == 0)
+                return j;
+        return -1;
+    }
 
-    /** @brief Check if the game ended in a draw. */
-    virtual bool is_draw(Player<T>*) = 0;
+    /** @brief Score to store for a node @p ply plies from the root (wins counted from the node). */
+    static int to_table(int score, int ply) {
+        if (score > WIN_SCORE - MAX_PLY) return score + ply;
+        if (score < MAX_PLY - WIN_SCORE) return score - ply;
+        return score;
+    }
 
-    /** @brief Check if the game is over. */
-    virtual bool game_is_over(Player<T>*) = 0;
+    /** @brief Inverse of to_table. */
+    static int from_table(int score, int ply) {
+        if (score > WIN_SCORE - MAX_PLY) return score - ply;
+        if (score < MAX_PLY - WIN_SCORE) return score + ply;
+        return score;
+    }
+
+    /** @brief Check whether stop was called or the deadline has passed. */
+    bool interrupted() const {
+        return stop_requested.load(memory_order_relaxed) ||
+               (timed && chrono::steady_clock::now() >= deadline);
+    }
+
+    /** @brief Check the budget after a new position; sets and returns @c stopped. */
+    bool out_of_budget() {
+        if ((max_nodes && nodes >= max_nodes) || ((nodes & 7) == 0 && interrupted()))
+            stopped = true;
+        return stopped;
+    }
 
     /**
-     * @brief Return a copy of the current board as a 2D vector.
+     * @brief Play @p move for @p side and return its score for @p side, or
+     *        -INFINITE_SCORE if the board rejects it.
+     *
+     * The reply is searched within (alpha, beta), seen from @p side. The
+     * score means nothing once @c stopped is set.
      */
-    vector<vector<T>> get_board_matrix() const {
-        return board;
+    template <typename BoardT>
+    int score_move(BoardT& board, const Move<T>& move, Player<T>* side, Player<T>* other,
+                   int depth, int ply, int alpha, int beta, bool full_window) {
+        if (!board.make_move(move))
+            return -INFINITE_SCORE;
+        ++nodes;
+        int score;
+        if (out_of_budget())
+            score = 0;
+        else if (board.is_win(side))
+            score = WIN_SCORE - ply;
+        else if (board.is_lose(side))
+            score = ply - WIN_SCORE;
+        else if (board.is_draw(side))
+            score = 0;
+        else if (depth <= 1 || ply + 1 >= MAX_PLY) {
+            score = board.evaluate(side);
+            horizon = true;
+        }
+        else if (full_window)
+            score = -negamax(board, other, side, depth - 1, ply + 1, -beta, -alpha);
+        else {
+            score = -negamax(board, other, side, depth - 1, ply + 1, -alpha - 1, -alpha);
+            if (score > alpha && score < beta)
+                score = -negamax(board, other, side, depth - 1, ply + 1, -beta, -alpha);
+        }
+        board.unmake_move();
+        return score;
     }
 
-    /** @brief Get number of rows. */
-    int get_rows() const { return rows; }
+    /** @brief Score for @p side, to move, searched @p depth plies deep. */
+    template <typename BoardT>
+    int negamax(BoardT& board, Player<T>* side, Player<T>* other, int depth, int ply,
+                int alpha, int beta) {
+        int transform = 0;
+        unsigned long long key = hashed ? board.get_canonical_hash(&transform) : 0;
+        int table_move = -1;
+        TTEntry entry;
+        if (key && table->probe(key, entry, table_stats)) {
+            table_move = entry.move;
+            if (entry.depth >= depth) {
+                int score = from_table(entry.score, ply);
+                if (entry.bound == TT_EXACT ||
+                    (entry.bound == TT_LOWER && score >= beta) ||
+                    (entry.bound == TT_UPPER && score <= alpha)) {
+                    if (entry.depth != SOLVED_DEPTH)
+                        horizon = true;
+                    return score;
+                }
+            }
+        }
+        bool outer_horizon = horizon;
+        horizon = false;
 
-    /** @brief Get number of columns. */
-    int get_columns() const { return columns; }
+        Frame& f = frame(ply);
+        MoveList<T>& moves = f.moves;
+        const Move<T>** order = f.order;
+        board.generate_moves(side, moves);
+        int n = order_moves(moves, ply, order, from_hint(board, moves, table_move, transform));
 
-    /** @brief Get number of moves. */
-    int get_n_moves() const { return n_moves; }
+        int original_alpha = alpha;
+        int best = -INFINITE_SCORE;
+        int best_move = -1;
+        for (int i = 0; i < n; ++i) {
+            int score = score_move(board, *order[i], side, other, depth, ply, alpha, beta,
+                                   best == -INFINITE_SCORE);
+            if (stopped)
+                return 0;
+            if (score <= best)
+                continue;
+            best = score;
+            best_move = static_cast<int>(order[i] - &moves[0]);
+            if (score > alpha)
+                alpha = score;
+            if (alpha >= beta) {
+                killers[ply] = *order[i];
+                has_killer[ply] = true;
+                break;
+            }
+        }
+        bool solved = !horizon;
+        horizon = outer_horizon || horizon;
+        if (best == -INFINITE_SCORE)
+            return 0;
 
-    /** @brief Return content of cell x, y in current board. */
-    T get_cell(int x, int y) {
-        return board[x][y];
+        if (key) {
+            TTBound bound = best <= original_alpha ? TT_UPPER : best >= beta ? TT_LOWER : TT_EXACT;
+            table->store(key, to_table(best, ply), solved ? SOLVED_DEPTH : depth, bound,
+                         to_hint(board, moves, best_move, transform), table_stats);
+        }
+        return best;
     }
-};
-
-//-----------------------------------------------------
-/**
- * @brief Represents a single move in a board game.
- *
- * @tparam T Type of symbol placed on the board (e.g., char, int).
- */
-template <typename T>
-class Move {
-    int x;      ///< Row index
-    int y;      ///< Column index
-    T symbol;   ///< Symbol used in the move
 
 public:
-    /** @brief Construct a move at (x, y) using a symbol. */
-    Move(int x, int y, T symbol) : x(x), y(y), symbol(symbol) {}
+    /**
+     * @brief Find the best move of @p side, with @p other replying, within
+     *        @p budget.
+     *
+     * The budget's depth caps the iterations (0: as deep as the board can
+     * take back), its nodes and millis stop the search wherever it is.
+     *
+     * @param random If given, the root moves are shuffled with it first, so
+     *        that equally good moves vary from game to game.
+     */
+    template <typename BoardT>
+    SearchResult<T> search(BoardT& board, Player<T>* side, Player<T>* other,
+                           const MoveBudget& budget, GameRandom* random = nullptr) {
+        int room = MAX_PLY - board.get_undo_depth();
+        int max_depth = budget.depth > 0 ? min(budget.depth, room) : room;
+        nodes = 0;
+        max_nodes = budget.nodes;
+        timed = false; // until the first iteration is complete
+        deadline = chrono::steady_clock::now() + chrono::microseconds(budget.millis * 900);
+        stopped = false;
+        stop_requested.store(false, memory_order_relaxed);
+        fill(has_killer, has_killer + MAX_PLY, false);
+        table_stats = TTStats();
+        hashed = table && board.get_zobrist_table();
 
+        Frame& root = frame(0);
+        const Move<T>** order = root.order;
+        board.generate_moves(side, root.moves);
+        int n = order_moves(root.moves, 0, order);
+        if (random)
+            for (int i = n - 1; i > 0; --i)
+                swap(order[i], order[random->below(i + 1)]);
 
-    /** @brief Get row index. */
-    int get_x() const { return x; }
+        SearchResult<T> result;
+        result.move = n ? *order[0] : Move<T>(-1, -1, side->get_symbol());
+        for (int depth = 1; depth <= max_depth; ++depth) {
+            horizon = false;
+            int alpha = -INFINITE_SCORE;
+            int best = -1;
+            for (int i = 0; i < n; ++i) {
+                if (interrupted())
+                    stopped = true;
+                if (stopped)
+                    break;
+                int score = score_move(board, *order[i], side, other, depth, 1, alpha,
+                                       INFINITE_SCORE, alpha == -INFINITE_SCORE);
+                if (stopped)
+                    break;
+                if (score > alpha) {
+                    alpha = score;
+                    best = i;
+                }
+            }
+            if (best < 0)
+                break;
+            // Moves are searched best first, so a move that beat the
+            // previous best before the budget ran out is better still.
+            result.move = *order[best];
+            result.score = alpha;
+            rotate(order, order + best, order + best + 1);
+            if (stopped)
+                break;
+            result.depth = depth;
+            timed = budget.millis > 0;
+            if (!horizon || is_decisive(alpha))
+                break;
+        }
+        result.nodes = nodes;
+        if (hashed)
+            table->add_stats(table_stats);
+        return result;
+    }
 
-    /** @brief Get column index. */
-    int get_y() const { return y; }
+    /**
+     * @brief Make the running search return as soon as possible, with the
+     *        best move it has found. May be called from another thread;
+     *        has no effect on searches started afterwards.
+     */
+    void stop() { stop_requested.store(true, memory_order_relaxed); }
 
-    /** @brief Get the move symbol. */
-    T get_symbol() const { return symbol; }
+    /**
+     * @brief Use @p tt (nullptr: none) as the position cache of the
+     *        following searches on hashed boards. The table is not owned;
+     *        its owner calls TranspositionTable::new_search between moves.
+     */
+    void set_table(TranspositionTable* tt) { table = tt; }
+
+    /** @brief Position cache in use (nullptr if none). */
+    TranspositionTable* get_table() const { return table; }
 
+    /** @brief Table counters of the last search. */
+    const TTStats& get_table_stats() const { return table_stats; }
+
+    /** @brief Positions visited by the last search. */
+    long long get_nodes() const { return nodes; }
+
+    /** @brief Check whether @p score means a forced win or loss. */
+    static bool is_decisive(int score) { return abs(score) > WIN_SCORE - MAX_PLY; }
 };
 
-//-----------------------------------------------------
 /**
- * @brief Base template for all players (human or AI).
+ * @brief Agent that plays the best move found by NegamaxSearch.
  *
- * @tparam T Type of symbol used by the player.
+ * The agent needs the opponent to generate its replies. Its default
+ * budget is one second per move, which the small variants do not need:
+ * the search stops as soon as it has solved the position. It keeps its
+ * own transposition table from move to move.
  */
 template <typename T>
-class Player {
-protected:
-    string name;         ///< Player name
-    PlayerType type;     ///< Player type (e.g., HUMAN or COMPUTER)
-    T symbol;            ///< Players symbol on board
-    Board<T>* boardPtr;  ///< Pointer to the game board
+class SearchAgent final : public MoveAgent<T> {
+    Player<T>* opponent;     ///< Player replying to the agent's moves
+    GameRandom* random;      ///< Generator for shuffling equal moves (nullptr: the thread's)
+    NegamaxSearch<T> engine; ///< Search engine
+    TranspositionTable table; ///< Positions seen by the agent's searches
+    SearchResult<T> last;    ///< Result of the last search
+
+    template <typename BoardT>
+    Move<T> search(BoardT& board, Player<T>* player, const MoveBudget& budget) {
+        table.new_search();
+        last = engine.search(board, player, opponent, budget, random ? random : &thread_random());
+        return last.move;
+    }
 
 public:
     /**
-     * @brief Construct a player with name, symbol, and type.
+     * @brief Construct an agent playing against @p opponent, shuffling
+     *        equally good moves with @p random, with a transposition
+     *        table of @p table_mb MB.
      */
-    Player(string n, T s, PlayerType t)
-        : name(n), symbol(s), type(t), boardPtr(nullptr) {}
+    explicit SearchAgent(Player<T>* opponent, GameRandom* random = nullptr, size_t table_mb = 16)
+        : opponent(opponent), random(random), table(table_mb) {
+        engine.set_table(&table);
+        this->budget.millis = 1000;
+    }
 
-    virtual ~Player() {}
+    using MoveAgent<T>::choose_move;
 
-    /** @brief Get the player's name. */
-    string get_name() const { return name; }
+    Move<T> choose_move(Board<T>& board, Player<T>* player, const MoveBudget& budget) override {
+        return search(board, player, budget);
+    }
 
-    /** @brief Get player type (e.g., 'H' or 'C'). */
-    PlayerType get_type() const { return type; }
+    /**
+     * @brief choose_move for a board whose concrete type is known, so that
+     *        every board call of the search is resolved at compile time.
+     */
+    template <typename BoardT>
+    Move<T> choose_move(BoardT& board, Player<T>* player) {
+        return search(board, player, this->budget);
+    }
 
-    /** @brief Get the player's symbol. */
-    T get_symbol() const { return symbol; }
+    /** @brief Stop the running search (see NegamaxSearch::stop). */
+    void stop() { engine.stop(); }
 
-    /** @brief Get a pointer to the game board. */
-    Board<T>* get_board_ptr() const { return boardPtr; }
+    /** @brief Result (move, score, node count and depth) of the last search. */
+    const SearchResult<T>& get_last_result() const { return last; }
 
-    /** @brief Assign the board pointer for the player. */
-    void set_board_ptr(Board<T>* b) { boardPtr = b; }
+    /** @brief Positions visited by the last search. */
+    long long get_nodes() const { return last.nodes; }
+
+    /** @brief The agent's transposition table. */
+    TranspositionTable& get_table() { return table; }
+};
+
+//-----------------------------------------------------
+/**
+ * @brief Result of a game played with GameManager::run_headless.
+ *
+ * @tparam T Type of symbol used on the board.
+ */
+template <typename T>
+struct GameRecord {
+    int winner = -1;              ///< Index of the winning player, -1 if none
+    bool finished = false;        ///< false if the game was cut off before its end
+    int plies = 0;                ///< Number of moves played
+    unsigned long long hash = 0;  ///< Board::get_hash() of the final position
+    vector<Move<T>> moves;        ///< Moves played, in order
 };
 
 //-----------------------------------------------------
@@ -179,7 +2076,8 @@ public:
 template <typename T>
 class UI {
 protected:
-    int cell_width; ///< Width of each displayed board cell
+    int cell_width;            ///< Width of each displayed board cell
+    GameRandom* rng = nullptr; ///< Generator for computer moves, if injected
 
     /**
      * @brief Ask the user for the player's name.
@@ -193,6 +2091,8 @@ protected:
 
     /**
      * @brief Ask the user to choose the player type from a list.
+     *
+     * The options are listed in the order of player_type_options().
      */
     virtual PlayerType get_player_type_choice(string player_label, const vector<string>& options) {
         cout << "Choose " << player_label << " type:\n";
@@ -200,7 +2100,11 @@ protected:
             cout << i + 1 << ". " << options[i] << "\n";
         int choice;
         cin >> choice;
-        return (choice == 2) ? PlayerType::COMPUTER : PlayerType::HUMAN;
+        switch (choice) {
+        case 2:  return PlayerType::RANDOM;
+        case 3:  return PlayerType::AI;
+        default: return PlayerType::HUMAN;
+        }
     }
 
 public:
@@ -219,13 +2123,54 @@ public:
 
     virtual ~UI() {}
 
+    /**
+     * @brief Draw computer moves from @p random.
+     *
+     * Without an injected generator the calling thread's one is used.
+     */
+    void set_random(GameRandom* random) { rng = random; }
+
     /** @brief Display any message to the user. */
     virtual void display_message(string message) { cout << message << "\n"; }
 
     /**
      * @brief Ask the user (or AI) to make a move.
+     * @return The chosen move, by value.
+     */
+    virtual Move<T> get_move(Player<T>*) = 0;
+
+    /**
+     * @brief Let a computer player's agent choose its move.
+     *
+     * A player without an agent plays a uniformly random legal move. Returns
+     * an empty move (rejected by every board) if the player has no legal
+     * move.
+     */
+    Move<T> computer_move(Player<T>* player) {
+        Board<T>& board = *player->get_board_ptr();
+        if (MoveAgent<T>* agent = player->get_agent())
+            return agent->choose_move(board, player);
+        return RandomAgent<T>(rng).choose_move(board, player);
+    }
+
+    /** @brief Player types offered by setup_players: human, random or AI. */
+    static vector<string> player_type_options() {
+        return { "Human", "Computer (random moves)", "Computer (AI search)" };
+    }
+
+    /**
+     * @brief Create the agent of a player of type @p type facing @p opponent.
+     *
+     * AI players get a SearchAgent, other computer players a RandomAgent,
+     * humans none.
      */
-    virtual Move<T>* get_move(Player<T>*) = 0;
+    virtual MoveAgent<T>* create_agent(PlayerType type, Player<T>* opponent) {
+        switch (type) {
+        case PlayerType::HUMAN: return nullptr;
+        case PlayerType::AI:    return new SearchAgent<T>(opponent, rng);
+        default:                return new RandomAgent<T>(rng);
+        }
+    }
 
     /**
      * @brief Set up players for the game.
@@ -238,14 +2183,13 @@ public:
     virtual Player<T>* create_player(string& name, T symbol, PlayerType type);
 
     /**
-     * @brief Display the current board matrix in formatted form.
+     * @brief Display the current board in formatted form.
      */
+    virtual void display_board_matrix(const BoardView<T>& matrix) const {
+        if (matrix.empty()) return;
 
-    virtual void display_board_matrix(const vector<vector<T>>& matrix) const {
-        if (matrix.empty() || matrix[0].empty()) return;
-
-        int rows = matrix.size();
-        int cols = matrix[0].size();
+        int rows = matrix.get_rows();
+        int cols = matrix.get_columns();
 
         cout << "\n    ";
         for (int j = 0; j < cols; ++j)
@@ -262,23 +2206,136 @@ public:
     }
 };
 
+//-----------------------------------------------------
+/**
+ * @brief Steps of a turn that GameManager can time.
+ */
+enum class TurnPhase {
+    GET_MOVE,      ///< Asking the UI or agent for a move
+    UPDATE_BOARD,  ///< Applying (or rejecting) the move
+    IS_WIN,        ///< Board::is_win
+    IS_LOSE,       ///< Board::is_lose
+    IS_DRAW,       ///< Board::is_draw
+    COUNT          ///< Number of phases
+};
+
+/**
+ * @brief Metrics policy of GameManager that records nothing.
+ *
+ * This is the default policy; with it no clock is read and every hook
+ * compiles away. A recording policy (see BoardGame_Metrics.h) provides
+ * the same members with @c enabled set to true.
+ */
+struct NoMetrics {
+    static constexpr bool enabled = false;    ///< Whether GameManager times turns
+
+    void record(TurnPhase, long long) {}      ///< Add time spent in a phase of the current ply
+    void record_rejection() {}                ///< Count a move rejected by update_board
+    void end_ply() {}                         ///< Close the current ply
+    void end_game() {}                        ///< Close the current game
+};
+
+/**
+ * @brief Call @p step and, if @p metrics is enabled, record its duration.
+ */
+template <typename Metrics, typename Step>
+auto timed_step(Metrics& metrics, TurnPhase phase, Step step) -> decltype(step()) {
+    if constexpr (Metrics::enabled) {
+        auto start = chrono::steady_clock::now();
+        auto result = step();
+        metrics.record(phase, chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now() - start).count());
+        return result;
+    }
+    else {
+        return step();
+    }
+}
+
+/**
+ * @brief Play one game between two agents without any I/O.
+ *
+ * Shared by GameManager::run_headless (with BoardT = Board<T>, every call
+ * virtual) and StaticGameManager (with a final board class, every board
+ * call resolved at compile time). @p first moves first. The game stops at
+ * the first win, loss or draw; it is cut off after @p max_plies moves or
+ * when an agent's move is rejected by the board.
+ *
+ * @param record Receives the result. Its move vector is cleared but keeps
+ *        its capacity, so one record can be reused for many games.
+ */
+template <typename BoardT, typename AgentA, typename AgentB, typename Metrics>
+void play_headless(BoardT& board, Player<typename BoardT::cell_type>* players[2],
+                   AgentA& first, AgentB& second, Metrics& metrics,
+                   GameRecord<typename BoardT::cell_type>& record, int max_plies) {
+    typedef typename BoardT::cell_type T;
+    record.winner = -1;
+    record.finished = false;
+    record.plies = 0;
+    record.moves.clear();
+
+    while (record.plies < max_plies) {
+        int i = record.plies % 2;
+        Player<T>* currentPlayer = players[i];
+        Move<T> move = timed_step(metrics, TurnPhase::GET_MOVE, [&] {
+            return i == 0 ? first.choose_move(board, currentPlayer)
+                          : second.choose_move(board, currentPlayer);
+            });
+
+        if (!timed_step(metrics, TurnPhase::UPDATE_BOARD, [&] { return board.update_board(move); })) {
+            metrics.record_rejection();
+            metrics.end_ply();
+            break;
+        }
+        record.moves.push_back(move);
+        ++record.plies;
+
+        if (timed_step(metrics, TurnPhase::IS_WIN, [&] { return board.is_win(currentPlayer); })) {
+            record.winner = i;
+            record.finished = true;
+        }
+        else if (timed_step(metrics, TurnPhase::IS_LOSE, [&] { return board.is_lose(currentPlayer); })) {
+            record.winner = 1 - i;
+            record.finished = true;
+        }
+        else if (timed_step(metrics, TurnPhase::IS_DRAW, [&] { return board.is_draw(currentPlayer); })) {
+            record.finished = true;
+        }
+        metrics.end_ply();
+        if (record.finished)
+            break;
+    }
+    metrics.end_game();
+    record.hash = board.get_hash();
+}
+
 //-----------------------------------------------------
 /**
  * @brief Controls the flow of a board game between two players.
  *
  * @tparam T Type of symbol used on the board.
+ * @tparam Metrics Policy receiving per-ply timings (NoMetrics by default).
  */
-template <typename T>
+template <typename T, typename Metrics = NoMetrics>
 class GameManager {
     Board<T>* boardPtr;    ///< Game board
     Player<T>* players[2]; ///< Two players
     UI<T>* ui;             ///< User interface
+    Metrics metrics;       ///< Turn metrics sink
+
+    /** @brief Call @p step, timing it if metrics are enabled. */
+    template <typename Step>
+    auto timed(TurnPhase phase, Step step) -> decltype(step()) {
+        return timed_step(metrics, phase, step);
+    }
 
 public:
     /**
      * @brief Construct a game manager with board, players, and UI.
+     *
+     * The UI may be left out for managers that only run headless games.
      */
-    GameManager(Board<T>* b, Player<T>* p[2], UI<T>* u)
+    GameManager(Board<T>* b, Player<T>* p[2], UI<T>* u = nullptr)
         : boardPtr(b), ui(u) {
         players[0] = p[0];
         players[1] = p[1];
@@ -286,38 +2343,109 @@ public:
         players[1]->set_board_ptr(b);
     }
 
+    /** @brief Access the metrics sink (e.g. to print or merge its results). */
+    Metrics& get_metrics() { return metrics; }
+
     /**
      * @brief Run the main game loop until someone wins or the game ends.
      */
     void run() {
-        ui->display_board_matrix(boardPtr->get_board_matrix());
+        ui->display_board_matrix(boardPtr->view());
         Player<T>* currentPlayer = players[0];
 
         while (true) {
             for (int i : {0, 1}) {
                 currentPlayer = players[i];
-                Move<T>* move = ui->get_move(currentPlayer);
+                Move<T> move = timed(TurnPhase::GET_MOVE, [&] { return ui->get_move(currentPlayer); });
 
-                while (!boardPtr->update_board(move))
-                    move = ui->get_move(currentPlayer);
+                while (!timed(TurnPhase::UPDATE_BOARD, [&] { return boardPtr->update_board(move); })) {
+                    metrics.record_rejection();
+                    move = timed(TurnPhase::GET_MOVE, [&] { return ui->get_move(currentPlayer); });
+                }
 
-                ui->display_board_matrix(boardPtr->get_board_matrix());
+                ui->display_board_matrix(boardPtr->view());
 
-                if (boardPtr->is_win(currentPlayer)) {
-                    ui->display_message(currentPlayer->get_name() + " wins!");
-                    return;
-                }
-                if (boardPtr->is_lose(currentPlayer)) {
-                    ui->display_message(players[1 - i]->get_name() + " wins!");
-                    return;
-                }
-                if (boardPtr->is_draw(currentPlayer)) {
-                    ui->display_message("Draw!");
+                string result;
+                if (timed(TurnPhase::IS_WIN, [&] { return boardPtr->is_win(currentPlayer); }))
+                    result = currentPlayer->get_name() + " wins!";
+                else if (timed(TurnPhase::IS_LOSE, [&] { return boardPtr->is_lose(currentPlayer); }))
+                    result = players[1 - i]->get_name() + " wins!";
+                else if (timed(TurnPhase::IS_DRAW, [&] { return boardPtr->is_draw(currentPlayer); }))
+                    result = "Draw!";
+                metrics.end_ply();
+
+                if (!result.empty()) {
+                    metrics.end_game();
+                    ui->display_message(result);
                     return;
                 }
             }
         }
     }
+
+    /**
+     * @brief Play one game between two agents without any I/O.
+     *
+     * @p agents[i] chooses the moves of player i, starting with player 0.
+     * The game stops at the first win, loss or draw; it is cut off after
+     * @p max_plies moves or when an agent's move is rejected by the board.
+     *
+     * @param record Receives the result. Its move vector is cleared but keeps
+     *        its capacity, so one record can be reused for many games.
+     */
+    void run_headless(MoveAgent<T>* agents[2], GameRecord<T>& record, int max_plies = 1000) {
+        play_headless(*boardPtr, players, *agents[0], *agents[1], metrics, record, max_plies);
+    }
+};
+
+//-----------------------------------------------------
+/**
+ * @brief Headless game runner for a board and agents known at compile time.
+ *
+ * @tparam BoardT Concrete board class. When it is @c final (as all X-O
+ *         boards are) every board call is dispatched statically and can be
+ *         inlined.
+ * @tparam AgentA Agent of the first player; needs
+ *         <tt>Move choose_move(BoardT&, Player*)</tt>.
+ * @tparam AgentB Agent of the second player.
+ * @tparam Metrics Policy receiving per-ply timings (NoMetrics by default).
+ *
+ * It plays exactly like GameManager::run_headless; interactive games keep
+ * using GameManager.
+ */
+template <typename BoardT, typename AgentA, typename AgentB, typename Metrics = NoMetrics>
+class StaticGameManager {
+public:
+    typedef typename BoardT::cell_type T; ///< Type of symbol used on the board
+
+private:
+    BoardT& board;         ///< Game board
+    Player<T>* players[2]; ///< Two players
+    AgentA& first;         ///< Agent of players[0]
+    AgentB& second;        ///< Agent of players[1]
+    Metrics metrics;       ///< Turn metrics sink
+
+public:
+    /**
+     * @brief Construct a runner for @p board with an agent for each player.
+     */
+    StaticGameManager(BoardT& board, Player<T>* p[2], AgentA& first, AgentB& second)
+        : board(board), first(first), second(second) {
+        players[0] = p[0];
+        players[1] = p[1];
+        players[0]->set_board_ptr(&board);
+        players[1]->set_board_ptr(&board);
+    }
+
+    /** @brief Access the metrics sink (e.g. to print or merge its results). */
+    Metrics& get_metrics() { return metrics; }
+
+    /**
+     * @brief Play one game; see play_headless for how it ends.
+     */
+    void run(GameRecord<T>& record, int max_plies = 1000) {
+        play_headless(board, players, first, second, metrics, record, max_plies);
+    }
 };
 
 //-----------------------------------------------------
@@ -327,7 +2455,7 @@ public:
 template <typename T>
 Player<T>** UI<T>::setup_players() {
     Player<T>** players = new Player<T>*[2];
-    vector<string> type_options = { "Human", "Computer" };
+    vector<string> type_options = player_type_options();
 
     string nameX = get_player_name("Player X");
     PlayerType typeX = get_player_type_choice("Player X", type_options);
@@ -337,6 +2465,8 @@ Player<T>** UI<T>::setup_players() {
     PlayerType typeO = get_player_type_choice("Player O", type_options);
     players[1] = create_player(nameO, static_cast<T>('O'), typeO);
 
+    players[0]->set_agent(create_agent(typeX, players[1]));
+    players[1]->set_agent(create_agent(typeO, players[0]));
     return players;
 }
 
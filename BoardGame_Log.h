@@ -0,0 +1,426 @@
+/**
+ * @file BoardGame_Log.h
+ * @brief Append-only log of played games and a memory-mapped reader.
+ *
+ * A log is a file header followed by one record per game:
+ * @code
+ * file header  'B' 'G' 'L' 'G' version 0 0 0
+ * record       variant (1 byte)  flags (1 byte)  plies (2 bytes)  seed (8 bytes)
+ *              plies moves
+ * move         x y (one byte, 4 bits each; or one byte each if LOG_WIDE)
+ *              symbol (1 byte)  direction (1 byte, only if LOG_DIRECTED)
+ * @endcode
+ * Numbers are little-endian. Bits 2-3 of the flags hold the GameLogResult.
+ *
+ * The seed is the one the board drew its random events from, so every
+ * game can be replayed move by move through Board::update_board (see
+ * replay_game). Records only ever get appended; a record cut short by a
+ * crash is ignored by the reader.
+ */
+
+#ifndef _BOARDGAME_LOG_H
+#define _BOARDGAME_LOG_H
+
+#include "BoardGame_Classes.h"
+
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const unsigned char GAME_LOG_MAGIC[4] = { 'B', 'G', 'L', 'G' }; ///< First bytes of a log file
+const int GAME_LOG_VERSION = 1;       ///< Format written by GameLogWriter
+const int GAME_LOG_HEADER = 8;        ///< Bytes in the file header
+const int GAME_LOG_RECORD_HEADER = 12; ///< Bytes in a record before its moves
+
+/// Record flags.
+enum GameLogFlags : unsigned char {
+    LOG_WIDE = 1,     ///< Coordinates take one byte each instead of 4 bits
+    LOG_DIRECTED = 2  ///< Moves carry a direction byte
+};
+
+/// How a logged game ended.
+enum GameLogResult : unsigned char {
+    LOG_CUT_OFF = 0,      ///< Stopped before its end
+    LOG_DRAW = 1,         ///< Draw
+    LOG_FIRST_WINS = 2,   ///< Won by the player who moved first
+    LOG_SECOND_WINS = 3   ///< Won by the other player
+};
+
+/** @brief Result code of a finished or cut-off game. */
+inline GameLogResult log_result(const GameRecord<char>& record) {
+    if (!record.finished) return LOG_CUT_OFF;
+    if (record.winner < 0) return LOG_DRAW;
+    return record.winner == 0 ? LOG_FIRST_WINS : LOG_SECOND_WINS;
+}
+
+/**
+ * @brief Append the log record of one game to @p out.
+ *
+ * @param variant Variant id, 0-255 (e.g. the xo_variant index).
+ * @param seed Seed of the board's random generator.
+ * @return false (and nothing appended) if the game cannot be logged: too
+ *         many plies or coordinates outside 0-255.
+ */
+inline bool encode_game(vector<unsigned char>& out, int variant, unsigned long long seed,
+                        const GameRecord<char>& record) {
+    int plies = static_cast<int>(record.moves.size());
+    if (variant < 0 || variant > 255 || plies > 0xFFFF)
+        return false;
+
+    unsigned char flags = static_cast<unsigned char>(log_result(record) << 2);
+    for (const Move<char>& move : record.moves) {
+        if (move.get_x() < 0 || move.get_x() > 255 || move.get_y() < 0 || move.get_y() > 255)
+            return false;
+        if (move.get_x() > 15 || move.get_y() > 15) flags |= LOG_WIDE;
+        if (move.get_direction()) flags |= LOG_DIRECTED;
+    }
+
+    out.push_back(static_cast<unsigned char>(variant));
+    out.push_back(flags);
+    out.push_back(static_cast<unsigned char>(plies));
+    out.push_back(static_cast<unsigned char>(plies >> 8));
+    for (int b = 0; b < 8; ++b)
+        out.push_back(static_cast<unsigned char>(seed >> (8 * b)));
+    for (const Move<char>& move : record.moves) {
+        if (flags & LOG_WIDE) {
+            out.push_back(static_cast<unsigned char>(move.get_x()));
+            out.push_back(static_cast<unsigned char>(move.get_y()));
+        }
+        else {
+            out.push_back(static_cast<unsigned char>(move.get_x() << 4 | move.get_y()));
+        }
+        out.push_back(static_cast<unsigned char>(move.get_symbol()));
+        if (flags & LOG_DIRECTED)
+            out.push_back(static_cast<unsigned char>(move.get_direction()));
+    }
+    return true;
+}
+
+//-----------------------------------------------------
+/**
+ * @brief Appends game records to a log file in large buffered writes.
+ *
+ * Records are encoded into an in-memory buffer that is written out once
+ * it holds BUFFER_SIZE bytes, on flush() and on close. A writer is not
+ * thread safe; parallel runners encode their games with encode_game and
+ * hand whole batches to write() under a lock.
+ */
+class GameLogWriter {
+public:
+    static const size_t BUFFER_SIZE = 1 << 20; ///< Bytes buffered before a write
+
+private:
+    FILE* file = nullptr;          ///< Open log, nullptr if none
+    vector<unsigned char> buffer;  ///< Encoded records not written yet
+    bool failed = false;           ///< Set when a write fails
+
+public:
+    GameLogWriter() { buffer.reserve(BUFFER_SIZE); }
+    ~GameLogWriter() { close(); }
+
+    GameLogWriter(const GameLogWriter&) = delete;
+    GameLogWriter& operator=(const GameLogWriter&) = delete;
+
+    /**
+     * @brief Open @p path for appending, writing the file header if the
+     *        file is new or empty.
+     * @return false if the file cannot be opened or is not a log.
+     */
+    bool open(const string& path) {
+        close();
+        failed = false;
+        file = fopen(path.c_str(), "ab+");
+        if (!file) return false;
+        setvbuf(file, nullptr, _IONBF, 0); // records are already batched
+
+        fseek(file, 0, SEEK_END);
+        if (ftell(file) == 0) {
+            unsigned char header[GAME_LOG_HEADER] = { GAME_LOG_MAGIC[0], GAME_LOG_MAGIC[1],
+                GAME_LOG_MAGIC[2], GAME_LOG_MAGIC[3], GAME_LOG_VERSION, 0, 0, 0 };
+            return write_out(header, GAME_LOG_HEADER);
+        }
+
+        unsigned char header[GAME_LOG_HEADER] = {};
+        fseek(file, 0, SEEK_SET);
+        if (fread(header, 1, GAME_LOG_HEADER, file) != static_cast<size_t>(GAME_LOG_HEADER) ||
+            memcmp(header, GAME_LOG_MAGIC, 4) != 0 || header[4] != GAME_LOG_VERSION) {
+            close();
+            return false;
+        }
+        fseek(file, 0, SEEK_END);
+        return true;
+    }
+
+    /** @brief Check whether a log is open and no write has failed. */
+    bool ok() const { return file && !failed; }
+
+    /**
+     * @brief Log one game; see encode_game.
+     * @return false if the game cannot be logged.
+     */
+    bool append(int variant, unsigned long long seed, const GameRecord<char>& record) {
+        if (!encode_game(buffer, variant, seed, record))
+            return false;
+        return buffer.size() < BUFFER_SIZE || flush();
+    }
+
+    /** @brief Append records already encoded with encode_game. */
+    bool write(Span<const unsigned char> records) {
+        if (buffer.size() + records.size() > BUFFER_SIZE && !flush())
+            return false;
+        if (records.size() >= BUFFER_SIZE)
+            return write_out(records.data(), records.size());
+        buffer.insert(buffer.end(), records.begin(), records.end());
+        return true;
+    }
+
+    /**
+     * @brief Write out every buffered record.
+     * @return false if this or any earlier write failed.
+     */
+    bool flush() {
+        if (!file) return false;
+        if (!buffer.empty())
+            write_out(buffer.data(), buffer.size());
+        buffer.clear();
+        return fflush(file) == 0 && !failed;
+    }
+
+    /** @brief Flush and close the log. */
+    void close() {
+        if (!file) return;
+        flush();
+        fclose(file);
+        file = nullptr;
+    }
+
+private:
+    /** @brief Write @p size bytes straight to the file. */
+    bool write_out(const unsigned char* bytes, size_t size) {
+        if (fwrite(bytes, 1, size, file) != size)
+            failed = true;
+        return !failed;
+    }
+};
+
+//-----------------------------------------------------
+/**
+ * @brief One game of a mapped log. Points into the mapping; nothing is copied.
+ */
+class GameLogEntry {
+    const unsigned char* record; ///< First byte of the record
+
+    /** @brief Bytes taken by each move. */
+    int move_size() const {
+        return ((record[1] & LOG_WIDE) ? 3 : 2) + ((record[1] & LOG_DIRECTED) ? 1 : 0);
+    }
+
+public:
+    explicit GameLogEntry(const unsigned char* record) : record(record) {}
+
+    /** @brief Variant id given to the writer. */
+    int get_variant() const { return record[0]; }
+
+    /** @brief How the game ended. */
+    GameLogResult get_result() const { return static_cast<GameLogResult>((record[1] >> 2) & 3); }
+
+    /** @brief Number of moves. */
+    int get_plies() const { return record[2] | record[3] << 8; }
+
+    /** @brief Seed of the board's random generator. */
+    unsigned long long get_seed() const {
+        unsigned long long seed = 0;
+        for (int b = 0; b < 8; ++b)
+            seed |= static_cast<unsigned long long>(record[4 + b]) << (8 * b);
+        return seed;
+    }
+
+    /** @brief Decode move @p i (0-based). */
+    Move<char> get_move(int i) const {
+        const unsigned char* m = record + GAME_LOG_RECORD_HEADER + i * move_size();
+        int x, y;
+        if (record[1] & LOG_WIDE) {
+            x = *m++;
+            y = *m++;
+        }
+        else {
+            x = *m >> 4;
+            y = *m++ & 15;
+        }
+        char symbol = static_cast<char>(*m++);
+        char direction = (record[1] & LOG_DIRECTED) ? static_cast<char>(*m) : 0;
+        return Move<char>(x, y, symbol, direction);
+    }
+
+    /** @brief Size of the whole record in bytes. */
+    size_t size() const { return GAME_LOG_RECORD_HEADER + static_cast<size_t>(get_plies()) * move_size(); }
+
+    /** @brief First byte of the record. */
+    const unsigned char* data() const { return record; }
+};
+
+/**
+ * @brief Reads a log file through a read-only memory mapping.
+ *
+ * Iterating yields a GameLogEntry per record, in file order. The whole
+ * file is mapped at once and paged in by the OS as it is read, so logs
+ * far larger than memory can be scanned. A trailing partial record is
+ * left out.
+ */
+class GameLogReader {
+    const unsigned char* bytes = nullptr; ///< Mapped file, nullptr if none
+    size_t length = 0;                    ///< Bytes mapped
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;   ///< Open log
+    HANDLE mapping = nullptr;             ///< Mapping of the log
+#endif
+
+public:
+    /** @brief Forward iterator over the records of a log. */
+    class iterator {
+        const GameLogReader* reader; ///< Log being read
+        size_t offset;               ///< Offset of the current record
+
+    public:
+        iterator(const GameLogReader* reader, size_t offset) : reader(reader), offset(offset) {}
+        GameLogEntry operator*() const { return GameLogEntry(reader->bytes + offset); }
+        iterator& operator++() {
+            offset = reader->complete(offset + GameLogEntry(reader->bytes + offset).size());
+            return *this;
+        }
+        bool operator!=(const iterator& other) const { return offset != other.offset; }
+        bool operator==(const iterator& other) const { return offset == other.offset; }
+    };
+
+    GameLogReader() {}
+    ~GameLogReader() { close(); }
+
+    GameLogReader(const GameLogReader&) = delete;
+    GameLogReader& operator=(const GameLogReader&) = delete;
+
+    /**
+     * @brief Map @p path.
+     * @return false if the file cannot be mapped or is not a log.
+     */
+    bool open(const string& path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart < GAME_LOG_HEADER) {
+            close();
+            return false;
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!view) {
+            close();
+            return false;
+        }
+        bytes = static_cast<const unsigned char*>(view);
+        length = static_cast<size_t>(size.QuadPart);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < GAME_LOG_HEADER) {
+            ::close(fd);
+            return false;
+        }
+        void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) return false;
+        madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+        bytes = static_cast<const unsigned char*>(view);
+        length = static_cast<size_t>(info.st_size);
+#endif
+        if (memcmp(bytes, GAME_LOG_MAGIC, 4) != 0 || bytes[4] != GAME_LOG_VERSION) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    /** @brief Unmap the log. */
+    void close() {
+#ifdef _WIN32
+        if (bytes) UnmapViewOfFile(bytes);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (bytes) munmap(const_cast<unsigned char*>(bytes), length);
+#endif
+        bytes = nullptr;
+        length = 0;
+    }
+
+    /** @brief Check whether a log is mapped. */
+    bool is_open() const { return bytes != nullptr; }
+
+    iterator begin() const { return iterator(this, bytes ? complete(GAME_LOG_HEADER) : 0); }
+    iterator end() const { return iterator(this, length); }
+
+    /** @brief Size of the mapped file in bytes. */
+    size_t size() const { return length; }
+
+private:
+    /**
+     * @brief @p offset if a whole record starts there, else the end of the
+     *        file (so iteration stops before a partial record).
+     */
+    size_t complete(size_t offset) const {
+        if (offset + GAME_LOG_RECORD_HEADER > length ||
+            offset + GameLogEntry(bytes + offset).size() > length)
+            return length;
+        return offset;
+    }
+};
+
+//-----------------------------------------------------
+/**
+ * @brief Replay a logged game on a fresh board.
+ *
+ * The board draws its random events from @p random, reseeded with the
+ * game's seed. After every move the game is checked exactly as
+ * play_headless does, so a faithful replay ends on the logged result.
+ *
+ * @param board Board of the game's variant in its initial position.
+ * @param players The two players, first mover first.
+ * @return Result reached, or -1 if a move is rejected or the game ends
+ *         before its last move.
+ */
+template <typename BoardT>
+int replay_game(const GameLogEntry& game, BoardT& board, Player<char>* players[2], GameRandom& random) {
+    random.reseed(game.get_seed());
+    board.set_random(&random);
+    int plies = game.get_plies();
+    for (int i = 0; i < plies; ++i) {
+        Player<char>* player = players[i % 2];
+        if (!board.update_board(game.get_move(i)))
+            return -1;
+
+        int result = -1;
+        if (board.is_win(player))
+            result = i % 2 == 0 ? LOG_FIRST_WINS : LOG_SECOND_WINS;
+        else if (board.is_lose(player))
+            result = i % 2 == 0 ? LOG_SECOND_WINS : LOG_FIRST_WINS;
+        else if (board.is_draw(player))
+            result = LOG_DRAW;
+        if (result >= 0)
+            return i == plies - 1 ? result : -1;
+    }
+    return LOG_CUT_OFF;
+}
+
+#endif // _BOARDGAME_LOG_H
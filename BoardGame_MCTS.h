@@ -0,0 +1,368 @@
+/**
+ * @file BoardGame_MCTS.h
+ * @brief Monte Carlo tree search (UCT) for every variant, on many threads.
+ *
+ * Alpha-beta (NegamaxSearch) has to look at every reply, so on boards
+ * with dozens of moves per ply (Ultimate, Diamond, Obstacles) it cannot
+ * see far. MCTSSearch instead plays random games from the position and
+ * grows a tree towards the moves that win most often. Several threads
+ * grow the same tree, each on its own copy of the board.
+ */
+
+#ifndef _BOARDGAME_MCTS_H
+#define _BOARDGAME_MCTS_H
+
+#include "BoardGame_Classes.h"
+
+#include <atomic>
+#include <thread>
+#include <cmath>
+#include <climits>
+#include <type_traits>
+
+/**
+ * @brief Heap copy of @p board that a worker thread can play on.
+ *
+ * A concrete board class is copied directly; through the Board interface
+ * the copy is made with Board::clone, which returns nullptr for boards
+ * that cannot be copied.
+ */
+template <typename BoardT>
+unique_ptr<BoardT> copy_board(const BoardT& board) {
+    if constexpr (is_abstract<BoardT>::value)
+        return unique_ptr<BoardT>(board.clone());
+    else
+        return unique_ptr<BoardT>(new BoardT(board));
+}
+
+//-----------------------------------------------------
+/**
+ * @brief Monte Carlo tree search with UCT selection and tree parallelism.
+ *
+ * @tparam T Type of symbol used on the board.
+ *
+ * Each iteration walks down the tree picking the child with the best
+ * upper confidence bound, expands the node it stops at, finishes the
+ * game with uniformly random moves and adds the result to every node on
+ * the way. Moves are played with make_move and taken back with
+ * unmake_move, so a playout allocates nothing; games still running after
+ * the board's undo depth count as draws.
+ *
+ * Nodes live in an arena allocated once by the constructor. A node's
+ * children are consecutive, claimed with one atomic add when the node is
+ * expanded, so the tree is never locked. Several workers share the tree:
+ * a worker counts its visit on each node as it goes down, before the
+ * result is known, so the others see a lower win rate there and spread
+ * out (virtual loss). When the arena is full the tree stops growing and
+ * playouts start from its leaves.
+ *
+ * The budget's @c nodes is the number of playouts and @c millis the
+ * wall-clock time; the search stops at whichever comes first.
+ */
+template <typename T>
+class MCTSSearch {
+public:
+    static const int DEFAULT_PLAYOUTS = 10000;     ///< Playouts when the budget sets no limit
+    static const int DEFAULT_CAPACITY = 1 << 20;   ///< Nodes in the arena by default
+
+private:
+    /// Expansion states of a node.
+    enum NodeState { LEAF, EXPANDING, EXPANDED };
+
+    /** @brief One position of the tree, reached by @c move. */
+    struct Node {
+        atomic<int> visits;   ///< Playouts through the node, running ones included
+        atomic<int> score;    ///< Half-points won by the player who played @c move
+        atomic<int> state;    ///< NodeState
+        int first_child;      ///< Arena index of the first child
+        int n_children;       ///< Number of children (0 for a leaf)
+        Move<T> move;         ///< Move leading to the node
+
+        Node() : visits(0), score(0), state(LEAF), first_child(0), n_children(0) {}
+    };
+
+    unique_ptr<Node[]> arena;        ///< Every node; the root is arena[0]
+    int capacity;                    ///< Size of the arena
+    int threads;                     ///< Workers per search
+    double exploration = 1.4;        ///< UCT exploration constant
+    atomic<int> used{ 0 };           ///< Nodes handed out
+    atomic<long long> playouts{ 0 }; ///< Playouts started by the current search
+    atomic<bool> stop{ false };      ///< Set when the time is up
+
+    /** @brief Reset node @p index to an unvisited leaf reached by @p move. */
+    void init_node(int index, const Move<T>& move) {
+        Node& node = arena[index];
+        node.visits.store(0, memory_order_relaxed);
+        node.score.store(0, memory_order_relaxed);
+        node.state.store(LEAF, memory_order_relaxed);
+        node.first_child = 0;
+        node.n_children = 0;
+        node.move = move;
+    }
+
+    /**
+     * @brief Give the leaf @p node one child per move of @p player, unless
+     *        another worker is already doing it.
+     */
+    template <typename BoardT>
+    void expand(Node& node, BoardT& board, Player<T>* player, MoveList<T>& moves) {
+        int expected = LEAF;
+        if (!node.state.compare_exchange_strong(expected, EXPANDING, memory_order_acquire))
+            return;
+        board.generate_moves(player, moves);
+        int n = moves.size();
+        int first = n ? used.fetch_add(n, memory_order_relaxed) : 0;
+        if (n && first <= capacity - n) {
+            for (int i = 0; i < n; ++i)
+                init_node(first + i, moves[i]);
+            node.first_child = first;
+            node.n_children = n;
+        }
+        node.state.store(EXPANDED, memory_order_release);
+    }
+
+    /** @brief Child of @p node with the best upper confidence bound. */
+    Node& select_child(Node& node) const {
+        Node* children = &arena[node.first_child];
+        double log_visits = log(static_cast<double>(max(1, node.visits.load(memory_order_relaxed))));
+        Node* best = children;
+        double best_value = -1;
+        for (int i = 0; i < node.n_children; ++i) {
+            int visits = children[i].visits.load(memory_order_relaxed);
+            if (visits == 0)
+                return children[i];
+            double value = children[i].score.load(memory_order_relaxed) / (2.0 * visits) +
+                           exploration * sqrt(log_visits / visits);
+            if (value > best_value) {
+                best_value = value;
+                best = &children[i];
+            }
+        }
+        return *best;
+    }
+
+    /**
+     * @brief Winner of the game after @p players[ply % 2] moved: 0 or 1,
+     *        -1 for a draw, -2 if it goes on.
+     */
+    template <typename BoardT>
+    static int outcome(BoardT& board, Player<T>* players[2], int ply) {
+        Player<T>* mover = players[ply % 2];
+        if (board.is_win(mover)) return ply % 2;
+        if (board.is_lose(mover)) return 1 - ply % 2;
+        if (board.is_draw(mover)) return -1;
+        return -2;
+    }
+
+    /**
+     * @brief Run one iteration: select, expand, play out, take the moves
+     *        back down to undo depth @p base and back up the result.
+     */
+    template <typename BoardT>
+    void iterate(BoardT& board, Player<T>* players[2], GameRandom& rng, MoveList<T>& moves,
+                 Node** path, int base) {
+        int room = Board<T>::MAX_UNDO - base;
+        Node* node = &arena[0];
+        node->visits.fetch_add(1, memory_order_relaxed);
+        int length = 0, ply = 0, winner = -2;
+
+        // Selection and expansion
+        while (winner == -2 && ply < room) {
+            if (node->state.load(memory_order_acquire) != EXPANDED) {
+                if (node->visits.load(memory_order_relaxed) < 2)
+                    break;
+                expand(*node, board, players[ply % 2], moves);
+                if (node->state.load(memory_order_acquire) != EXPANDED)
+                    break;
+            }
+            if (node->n_children == 0)
+                break;
+            node = &select_child(*node);
+            node->visits.fetch_add(1, memory_order_relaxed);
+            path[length++] = node;
+            if (!board.make_move(node->move)) {
+                winner = 1 - ply % 2;
+                break;
+            }
+            winner = outcome(board, players, ply++);
+        }
+
+        // Random playout
+        while (winner == -2 && ply < room) {
+            board.generate_moves(players[ply % 2], moves);
+            if (moves.empty() || !board.make_move(moves[rng.below(moves.size())]))
+                break;
+            winner = outcome(board, players, ply++);
+        }
+        while (board.get_undo_depth() > base)
+            board.unmake_move();
+
+        // Back-up, each node scored for the player who moved into it
+        for (int i = 0; i < length; ++i) {
+            int mover = i % 2;
+            int points = winner == mover ? 2 : winner < 0 ? 1 : 0;
+            if (points)
+                path[i]->score.fetch_add(points, memory_order_relaxed);
+        }
+    }
+
+    /** @brief Loop of one worker until the budget is spent. */
+    template <typename BoardT>
+    void work(BoardT& board, Player<T>* players[2], GameRandom& rng, const MoveBudget& budget,
+              long long max_playouts, chrono::steady_clock::time_point deadline) {
+        MoveList<T> moves;
+        Node* path[Board<T>::MAX_UNDO];
+        int base = board.get_undo_depth();
+        for (long long done = 0; !stop.load(memory_order_relaxed); ++done) {
+            if (playouts.fetch_add(1, memory_order_relaxed) >= max_playouts)
+                break;
+            if (budget.millis && done % 64 == 0 && chrono::steady_clock::now() >= deadline) {
+                stop.store(true, memory_order_relaxed);
+                break;
+            }
+            iterate(board, players, rng, moves, path, base);
+        }
+    }
+
+public:
+    /**
+     * @brief Construct an engine running @p threads workers (0: one per
+     *        core) over an arena of @p capacity nodes.
+     */
+    explicit MCTSSearch(int threads = 0, int capacity = DEFAULT_CAPACITY)
+        : arena(new Node[max(1, capacity)]), capacity(max(1, capacity)),
+          threads(threads > 0 ? threads : max(1, static_cast<int>(thread::hardware_concurrency()))) {}
+
+    /** @brief Set the number of workers (0: one per core). */
+    void set_threads(int n) {
+        threads = n > 0 ? n : max(1, static_cast<int>(thread::hardware_concurrency()));
+    }
+
+    /** @brief Number of workers per search. */
+    int get_threads() const { return threads; }
+
+    /** @brief Set the UCT exploration constant (1.4 by default). */
+    void set_exploration(double c) { exploration = c; }
+
+    /**
+     * @brief Find the best move of @p side, with @p other replying.
+     *
+     * Extra workers play on copies of @p board (see copy_board); if it
+     * cannot be copied the search runs on one thread. The move returned is
+     * the most visited child of the root; the result's @c score is its win
+     * rate in thousandths (draws counting half) and @c nodes the number of
+     * playouts.
+     *
+     * @param random Seeds the workers' generators (nullptr: the thread's).
+     */
+    template <typename BoardT>
+    SearchResult<T> search(BoardT& board, Player<T>* side, Player<T>* other,
+                           const MoveBudget& budget, GameRandom* random = nullptr) {
+        Player<T>* players[2] = { side, other };
+        GameRandom& seeds = random ? *random : thread_random();
+        long long max_playouts = budget.nodes ? budget.nodes
+                               : budget.millis ? LLONG_MAX : DEFAULT_PLAYOUTS;
+        auto deadline = chrono::steady_clock::now() + chrono::milliseconds(budget.millis);
+
+        init_node(0, Move<T>(-1, -1, side->get_symbol()));
+        used.store(1, memory_order_relaxed);
+        playouts.store(0, memory_order_relaxed);
+        stop.store(false, memory_order_relaxed);
+        MoveList<T> moves;
+        expand(arena[0], board, side, moves);
+
+        vector<unique_ptr<BoardT>> copies;
+        vector<GameRandom> generators;
+        generators.reserve(threads);
+        for (int i = 0; i < threads; ++i) {
+            generators.emplace_back(seeds.next());
+            if (i == 0) continue;
+            unique_ptr<BoardT> copy = copy_board(board);
+            if (!copy) break;
+            copy->set_random(&generators[i]);
+            copies.push_back(move(copy));
+        }
+
+        vector<thread> workers;
+        for (size_t i = 0; i < copies.size(); ++i)
+            workers.emplace_back([&, i] {
+                work(*copies[i], players, generators[i + 1], budget, max_playouts, deadline);
+                });
+        work(board, players, generators[0], budget, max_playouts, deadline);
+        for (thread& worker : workers)
+            worker.join();
+
+        SearchResult<T> result;
+        result.move = arena[0].move;
+        Node& root = arena[0];
+        int best_visits = -1;
+        for (int i = 0; i < root.n_children; ++i) {
+            Node& child = arena[root.first_child + i];
+            int visits = child.visits.load(memory_order_relaxed);
+            if (visits > best_visits) {
+                best_visits = visits;
+                result.move = child.move;
+                result.score = visits ? static_cast<int>(child.score.load(memory_order_relaxed) * 500LL / visits) : 0;
+            }
+        }
+        result.nodes = min(playouts.load(memory_order_relaxed), max_playouts);
+        return result;
+    }
+
+    /** @brief Nodes of the arena used by the last search. */
+    int get_tree_size() const { return min(used.load(memory_order_relaxed), capacity); }
+};
+
+//-----------------------------------------------------
+/**
+ * @brief Agent that plays the move found by MCTSSearch.
+ *
+ * The agent needs the opponent to play out its replies. Its default
+ * budget is one second per move on every core.
+ */
+template <typename T>
+class MCTSAgent final : public MoveAgent<T> {
+    Player<T>* opponent;   ///< Player replying to the agent's moves
+    GameRandom* random;    ///< Seeds the workers (nullptr: the thread's)
+    MCTSSearch<T> engine;  ///< Search engine
+    SearchResult<T> last;  ///< Result of the last search
+
+    template <typename BoardT>
+    Move<T> search(BoardT& board, Player<T>* player, const MoveBudget& budget) {
+        last = engine.search(board, player, opponent, budget, random);
+        return last.move;
+    }
+
+public:
+    /**
+     * @brief Construct an agent playing against @p opponent with
+     *        @p threads workers (0: one per core).
+     */
+    explicit MCTSAgent(Player<T>* opponent, GameRandom* random = nullptr, int threads = 0)
+        : opponent(opponent), random(random), engine(threads) {
+        this->budget.millis = 1000;
+    }
+
+    using MoveAgent<T>::choose_move;
+
+    Move<T> choose_move(Board<T>& board, Player<T>* player, const MoveBudget& budget) override {
+        return search(board, player, budget);
+    }
+
+    /**
+     * @brief choose_move for a board whose concrete type is known, so that
+     *        every board call of the search is resolved at compile time.
+     */
+    template <typename BoardT>
+    Move<T> choose_move(BoardT& board, Player<T>* player) {
+        return search(board, player, this->budget);
+    }
+
+    /** @brief The engine, e.g. to change its number of threads. */
+    MCTSSearch<T>& get_engine() { return engine; }
+
+    /** @brief Result (move, win rate and playouts) of the last search. */
+    const SearchResult<T>& get_last_result() const { return last; }
+};
+
+#endif // _BOARDGAME_MCTS_H
@@ -0,0 +1,329 @@
+/**
+ * @file BoardGame_MNK.h
+ * @brief Bitboard engine for "k in a row on an m x n grid" games.
+ *
+ * MNKBoard<M, N, K, Options> plays X and O on an M x N grid where K in a
+ * row wins, with optional gravity (Connect Four), blocked cells
+ * (obstacles) and count-all-lines scoring (5 x 5 X-O). Each player's
+ * pieces are also kept as a bitboard, so a whole-board line check is a
+ * handful of shifts and ANDs per direction instead of a loop over cells.
+ */
+
+#ifndef _BOARDGAME_MNK_H
+#define _BOARDGAME_MNK_H
+
+#include "BoardGame_Classes.h"
+
+#include <cctype>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/** @brief Number of set bits in @p bits. */
+inline int popcount64(unsigned long long bits) {
+#ifdef _MSC_VER
+    return static_cast<int>(__popcnt64(bits));
+#else
+    return __builtin_popcountll(bits);
+#endif
+}
+
+/**
+ * @brief Fixed-size bit set stored as 64-bit words.
+ *
+ * @tparam W Number of words.
+ *
+ * Only the operations line scanning needs are provided. All loops have a
+ * compile-time trip count, so the compiler unrolls them and, on wide
+ * boards, vectorizes them with whatever SIMD the target allows.
+ */
+template <int W>
+struct BitRows {
+    unsigned long long w[W] = {}; ///< Bit i lives in w[i / 64], bit i % 64
+
+    /** @brief Set bit @p i. */
+    void set(int i) { w[i >> 6] |= 1ULL << (i & 63); }
+
+    /** @brief Clear bit @p i. */
+    void reset(int i) { w[i >> 6] &= ~(1ULL << (i & 63)); }
+
+    /** @brief Check bit @p i. */
+    bool test(int i) const { return (w[i >> 6] >> (i & 63)) & 1; }
+
+    /** @brief Word @p i of the bits shifted towards bit 0 by @p s (s >= 0). */
+    unsigned long long shifted_word(int i, int s) const {
+        int from = i + (s >> 6), r = s & 63;
+        unsigned long long low = from < W ? w[from] >> r : 0;
+        unsigned long long high = r && from + 1 < W ? w[from + 1] << (64 - r) : 0;
+        return low | high;
+    }
+
+    BitRows& operator&=(const BitRows& other) {
+        for (int i = 0; i < W; ++i) w[i] &= other.w[i];
+        return *this;
+    }
+
+    /** @brief Check whether any bit is set. */
+    bool any() const {
+        unsigned long long bits = 0;
+        for (int i = 0; i < W; ++i) bits |= w[i];
+        return bits != 0;
+    }
+
+    /** @brief Number of set bits. */
+    int count() const {
+        int n = 0;
+        for (int i = 0; i < W; ++i) n += popcount64(w[i]);
+        return n;
+    }
+};
+
+/// Rule options of an MNKBoard.
+enum MNKOptions : unsigned {
+    MNK_GRAVITY = 1, ///< Pieces drop to the lowest empty cell of their column
+    MNK_SCORE = 2    ///< No early win: the game lasts an even number of moves and most lines wins
+};
+
+//-----------------------------------------------------
+/**
+ * @brief M x N board where K of a player's symbols in a row count as a line.
+ *
+ * @tparam M Number of rows (up to 19 and beyond).
+ * @tparam N Number of columns.
+ * @tparam K Length of a line.
+ * @tparam Options MNKOptions.
+ *
+ * Cells hold '.', 'X', 'O' or '#' (blocked). Besides the cells, the board
+ * keeps one bitboard per player in which cell (x, y) is bit
+ * x * (N + 1) + y: the spare bit at the end of each row is never set, so
+ * shifting by 1, N, N + 1 and N + 2 follows rows, anti-diagonals, columns
+ * and diagonals without wrapping round. ANDing K - 1 shifted copies
+ * leaves one bit per line start.
+ *
+ * Without MNK_SCORE the player who makes a line wins and a full board is a
+ * draw. With it, play stops after the largest even number of moves that
+ * fits on the board and the player with more lines wins.
+ *
+ * Variants derive from it, add their twist in update_board (calling
+ * place and block) and set up their Zobrist table. It can also be used
+ * directly, e.g. MNKBoard<19, 19, 5> for Gomoku.
+ */
+template <int M, int N, int K, unsigned Options = 0>
+class MNKBoard : public FixedBoard<char, M, N> {
+public:
+    static constexpr int STRIDE = N + 1;                  ///< Bits per bitboard row
+    static constexpr int WORDS = (M * STRIDE + 63) / 64;  ///< Words per bitboard
+    static constexpr int LENGTH = (Options & MNK_SCORE) ? M * N / 2 * 2 : M * N; ///< Most moves in a game
+    typedef BitRows<WORDS> Bits;                          ///< Bitboard type
+
+protected:
+    static constexpr char BLANK = '.';    ///< Empty cell
+    static constexpr char BLOCKED = '#';  ///< Cell no one can play
+
+    Bits pieces[2];   ///< Cells of X and O
+    Bits blocked;     ///< Blocked cells
+    int n_filled = 0; ///< Cells holding a piece or blocked
+
+public:
+    MNKBoard() { this->board.fill(BLANK); }
+
+    /** @brief Play @p move; see place. */
+    bool update_board(const Move<char>& move) override { return place(move); }
+
+    /**
+     * @brief List every cell the player may play: the lowest empty cell of
+     *        each column with gravity, every empty cell otherwise.
+     */
+    void generate_moves(Player<char>* player, MoveList<char>& moves) override {
+        moves.clear();
+        if (this->n_moves >= LENGTH)
+            return;
+        char symbol = player->get_symbol();
+        if (Options & MNK_GRAVITY) {
+            for (int y = 0; y < N; ++y)
+                for (int x = M - 1; x >= 0; --x)
+                    if (this->board[x][y] == BLANK) {
+                        moves.add(Move<char>(x, y, symbol));
+                        break;
+                    }
+        }
+        else {
+            this->list_empty_cells(BLANK, symbol, moves);
+        }
+    }
+
+    bool is_win(Player<char>* player) override {
+        int side = side_of(player->get_symbol());
+        if (side < 0) return false;
+        if (Options & MNK_SCORE)
+            return this->n_moves >= LENGTH && count_lines(side) > count_lines(1 - side);
+        return has_line(side);
+    }
+
+    bool is_lose(Player<char>* player) override {
+        int side = side_of(player->get_symbol());
+        if (side < 0) return false;
+        if (Options & MNK_SCORE)
+            return this->n_moves >= LENGTH && count_lines(side) < count_lines(1 - side);
+        return false;
+    }
+
+    bool is_draw(Player<char>* player) override {
+        if (Options & MNK_SCORE)
+            return this->n_moves >= LENGTH && count_lines(0) == count_lines(1);
+        int side = side_of(player->get_symbol());
+        return n_filled == M * N && !(side >= 0 && has_line(side));
+    }
+
+    bool game_is_over(Player<char>* player) override {
+        if (Options & MNK_SCORE)
+            return this->n_moves >= LENGTH;
+        return is_win(player) || is_draw(player);
+    }
+
+    /** @brief Check whether player @p side (0 for X, 1 for O) has a line. */
+    bool has_line(int side) const {
+        const Bits& bits = pieces[side];
+        return line_starts<1>(bits).any() || line_starts<STRIDE>(bits).any() ||
+               line_starts<STRIDE + 1>(bits).any() || line_starts<STRIDE - 1>(bits).any();
+    }
+
+    /** @brief Number of lines of player @p side, overlapping ones included. */
+    int count_lines(int side) const {
+        const Bits& bits = pieces[side];
+        return line_starts<1>(bits).count() + line_starts<STRIDE>(bits).count() +
+               line_starts<STRIDE + 1>(bits).count() + line_starts<STRIDE - 1>(bits).count();
+    }
+
+    /**
+     * @brief Heuristic score for @p player: the lines still open to them
+     *        minus those open to the opponent.
+     *
+     * A line counts as open to a player when it holds at least one of
+     * their pieces and none of the opponent's or blocked cells. With
+     * MNK_SCORE the lines already made weigh 16 times more.
+     */
+    int evaluate(Player<char>* player) override {
+        int side = side_of(player->get_symbol());
+        if (side < 0) return 0;
+        int score = open_lines(side) - open_lines(1 - side);
+        if (Options & MNK_SCORE)
+            score += 16 * (count_lines(side) - count_lines(1 - side));
+        return score;
+    }
+
+    /** @brief Number of lines that hold a piece of @p side and nothing of the other side. */
+    int open_lines(int side) const {
+        Bits open;
+        const Bits& cells = all_cells();
+        for (int i = 0; i < WORDS; ++i)
+            open.w[i] = cells.w[i] & ~(pieces[1 - side].w[i] | blocked.w[i]);
+        const Bits& own = pieces[side];
+        return open_in<1>(open, own) + open_in<STRIDE>(open, own) +
+               open_in<STRIDE + 1>(open, own) + open_in<STRIDE - 1>(open, own);
+    }
+
+    /** @brief Player index of @p symbol: 0 for X, 1 for O, -1 otherwise. */
+    static int side_of(char symbol) {
+        symbol = static_cast<char>(toupper(symbol));
+        return symbol == 'X' ? 0 : symbol == 'O' ? 1 : -1;
+    }
+
+protected:
+    CellAlphabet<char> cell_alphabet() const override { return CellAlphabet<char>(".XO#", 4); }
+
+    /**
+     * @brief Validate and apply a placement of X or O.
+     *
+     * The cell must be on the board and empty, the game must not have
+     * reached LENGTH moves and, with gravity, the cell below must be
+     * filled.
+     */
+    bool place(const Move<char>& move) {
+        int x = move.get_x(), y = move.get_y();
+        char symbol = static_cast<char>(toupper(move.get_symbol()));
+        int side = side_of(symbol);
+        if (side < 0 || x < 0 || x >= M || y < 0 || y >= N || this->n_moves >= LENGTH ||
+            this->board[x][y] != BLANK)
+            return false;
+        if ((Options & MNK_GRAVITY) && x < M - 1 && this->board[x + 1][y] == BLANK)
+            return false;
+
+        this->n_moves++;
+        this->set_cell(x, y, symbol);
+        pieces[side].set(x * STRIDE + y);
+        ++n_filled;
+        this->set_last_move(x, y);
+        return true;
+    }
+
+    /** @brief Block the empty cell (x, y) for the rest of the game. */
+    void block(int x, int y) {
+        this->set_cell(x, y, BLOCKED);
+        blocked.set(x * STRIDE + y);
+        ++n_filled;
+    }
+
+    /** @brief Mirror a cell written by unmake_move or restore_from in the bitboards. */
+    void sync_cell(int index) override {
+        int bit = index / N * STRIDE + index % N;
+        bool was_filled = pieces[0].test(bit) || pieces[1].test(bit) || blocked.test(bit);
+        pieces[0].reset(bit);
+        pieces[1].reset(bit);
+        blocked.reset(bit);
+
+        char cell = this->board.data()[index];
+        if (cell == BLOCKED) blocked.set(bit);
+        else if (side_of(cell) >= 0) pieces[side_of(cell)].set(bit);
+        n_filled += (cell != BLANK) - was_filled;
+    }
+
+private:
+    /**
+     * @brief Bits of @p bits that start K in a row with step @p S.
+     *
+     * Each word is built in one pass from the K shifted copies. The step is
+     * a template argument, so every word offset and shift is a constant and
+     * the loops unroll.
+     */
+    template <int S>
+    static Bits line_starts(const Bits& bits) {
+        Bits starts;
+        for (int i = 0; i < WORDS; ++i) {
+            unsigned long long word = bits.w[i];
+            for (int k = 1; k < K; ++k)
+                word &= bits.shifted_word(i, k * S);
+            starts.w[i] = word;
+        }
+        return starts;
+    }
+
+    /** @brief Lines with step @p S made only of @p open cells that touch @p own. */
+    template <int S>
+    static int open_in(const Bits& open, const Bits& own) {
+        Bits starts = line_starts<S>(open);
+        int n = 0;
+        for (int i = 0; i < WORDS; ++i) {
+            unsigned long long touched = own.w[i];
+            for (int k = 1; k < K; ++k)
+                touched |= own.shifted_word(i, k * S);
+            n += popcount64(starts.w[i] & touched);
+        }
+        return n;
+    }
+
+    /** @brief Bitboard with every cell of the grid set. */
+    static const Bits& all_cells() {
+        static const Bits cells = [] {
+            Bits bits;
+            for (int x = 0; x < M; ++x)
+                for (int y = 0; y < N; ++y)
+                    bits.set(x * STRIDE + y);
+            return bits;
+        }();
+        return cells;
+    }
+};
+
+#endif // _BOARDGAME_MNK_H
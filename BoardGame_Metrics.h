@@ -0,0 +1,159 @@
+/**
+ * @file BoardGame_Metrics.h
+ * @brief Recording metrics policy for GameManager.
+ *
+ * GameManager<T> records nothing by default. Instantiating it as
+ * GameManager<T, TurnMetrics> times every phase of every ply and counts
+ * the moves rejected by update_board, so slow variants and rejection
+ * storms can be found in self-play.
+ */
+
+#ifndef _BOARDGAME_METRICS_H
+#define _BOARDGAME_METRICS_H
+
+#include "BoardGame_Classes.h"
+
+/**
+ * @brief Metrics policy that records the time of each phase of each ply.
+ *
+ * Every ply is kept so that percentiles can be computed, and the totals
+ * of each game are kept when it ends. Sinks filled by different managers
+ * (for example one per thread) can be merged.
+ */
+class TurnMetrics {
+public:
+    static constexpr bool enabled = true;                      ///< GameManager times turns
+    static const int PHASES = static_cast<int>(TurnPhase::COUNT); ///< Number of timed phases
+
+    /** @brief Times and rejections of one ply. */
+    struct Ply {
+        long long ns[PHASES] = {};  ///< Time spent in each phase
+        unsigned char reached = 0;  ///< Bit p is set if phase p ran
+        int rejections = 0;         ///< Moves rejected before one was accepted
+    };
+
+    /** @brief Totals of one game. */
+    struct Game {
+        int plies = 0;              ///< Plies played
+        long long ns[PHASES] = {};  ///< Time spent in each phase
+        int rejections = 0;         ///< Moves rejected over the game
+    };
+
+private:
+    Ply ply;              ///< Ply being recorded
+    Game game;            ///< Game being recorded
+    vector<Ply> plies;    ///< Every finished ply
+    vector<Game> games;   ///< Every finished game
+
+public:
+    /** @brief Add @p ns nanoseconds spent in @p phase to the current ply. */
+    void record(TurnPhase phase, long long ns) {
+        ply.ns[static_cast<int>(phase)] += ns;
+        ply.reached |= 1 << static_cast<int>(phase);
+    }
+
+    /** @brief Count a move rejected by update_board in the current ply. */
+    void record_rejection() { ++ply.rejections; }
+
+    /** @brief Close the current ply and add it to the game totals. */
+    void end_ply() {
+        for (int p = 0; p < PHASES; ++p)
+            game.ns[p] += ply.ns[p];
+        game.rejections += ply.rejections;
+        ++game.plies;
+        plies.push_back(ply);
+        ply = Ply();
+    }
+
+    /** @brief Close the current game. */
+    void end_game() {
+        games.push_back(game);
+        game = Game();
+    }
+
+    /** @brief Every finished ply, in order. */
+    const vector<Ply>& get_plies() const { return plies; }
+
+    /** @brief Totals of every finished game, in order. */
+    const vector<Game>& get_games() const { return games; }
+
+    /** @brief Append the plies and games recorded by @p other. */
+    void merge(const TurnMetrics& other) {
+        plies.insert(plies.end(), other.plies.begin(), other.plies.end());
+        games.insert(games.end(), other.games.begin(), other.games.end());
+    }
+
+    /** @brief Forget everything recorded so far. */
+    void clear() {
+        ply = Ply();
+        game = Game();
+        plies.clear();
+        games.clear();
+    }
+
+    /**
+     * @brief Time of @p phase below which @p fraction of the plies fall.
+     *
+     * Only plies in which the phase ran are counted (is_lose, for example,
+     * is skipped after a win). Returns 0 if the phase never ran.
+     */
+    long long percentile(TurnPhase phase, double fraction) const {
+        int p = static_cast<int>(phase);
+        vector<long long> samples;
+        for (const Ply& t : plies)
+            if (t.reached & (1 << p))
+                samples.push_back(t.ns[p]);
+        if (samples.empty()) return 0;
+
+        size_t k = static_cast<size_t>(fraction * (samples.size() - 1) + 0.5);
+        nth_element(samples.begin(), samples.begin() + k, samples.end());
+        return samples[k];
+    }
+
+    /**
+     * @brief Print per-phase totals and percentiles, then game and rejection totals.
+     *
+     * The stream's format flags and precision are left as they were.
+     */
+    void print_summary(ostream& out) const {
+        static const char* names[PHASES] = { "get_move", "update_board", "is_win", "is_lose", "is_draw" };
+        ios::fmtflags flags = out.flags();
+        streamsize precision = out.precision();
+
+        out << left << setw(14) << "phase" << right << setw(12) << "calls" << setw(12) << "total ms"
+            << setw(10) << "mean ns" << setw(10) << "p50" << setw(10) << "p90"
+            << setw(10) << "p99" << setw(12) << "max" << "\n";
+        for (int p = 0; p < PHASES; ++p) {
+            TurnPhase phase = static_cast<TurnPhase>(p);
+            long long calls = 0, total = 0;
+            for (const Ply& t : plies)
+                if (t.reached & (1 << p)) {
+                    ++calls;
+                    total += t.ns[p];
+                }
+            out << left << setw(14) << names[p] << right << setw(12) << calls
+                << setw(12) << fixed << setprecision(2) << total / 1e6
+                << setw(10) << setprecision(0) << (calls ? double(total) / calls : 0.0)
+                << setw(10) << percentile(phase, 0.50) << setw(10) << percentile(phase, 0.90)
+                << setw(10) << percentile(phase, 0.99) << setw(12) << percentile(phase, 1.0) << "\n";
+        }
+
+        long long game_ns = 0, rejections = 0;
+        int worst_ply = 0;
+        for (const Game& g : games)
+            for (int p = 0; p < PHASES; ++p)
+                game_ns += g.ns[p];
+        for (const Ply& t : plies) {
+            rejections += t.rejections;
+            worst_ply = max(worst_ply, t.rejections);
+        }
+        out << games.size() << " games, " << plies.size() << " plies, "
+            << setprecision(0) << (games.empty() ? 0.0 : double(game_ns) / games.size())
+            << " ns per game; " << rejections << " rejected moves (at most "
+            << worst_ply << " in one ply)\n";
+        out.flags(flags);
+        out.precision(precision);
+    }
+};
+
+#endif // _BOARDGAME_METRICS_H
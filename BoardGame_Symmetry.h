@@ -0,0 +1,147 @@
+/**
+ * @file BoardGame_Symmetry.h
+ * @brief Rotations and reflections of square boards.
+ *
+ * Most square variants play the same after turning or mirroring the
+ * board, so a position and its seven images share their value. A
+ * SquareSymmetry holds where each cell goes under each of the eight
+ * transforms, precomputed once per board size, so that positions can be
+ * mapped to one canonical representative with table lookups only.
+ */
+
+#ifndef _BOARDGAME_SYMMETRY_H
+#define _BOARDGAME_SYMMETRY_H
+
+using namespace std;
+
+//-----------------------------------------------------
+/**
+ * @brief Permutation tables of the eight symmetries of an N x N board.
+ *
+ * Transform @c t mirrors the board left to right if <tt>t & 4</tt>, then
+ * turns it <tt>t & 3</tt> quarter turns clockwise; 0 is the identity.
+ * Cells are numbered row-major.
+ */
+class SquareSymmetry {
+public:
+    static const int TRANSFORMS = 8; ///< Number of symmetries of the square
+    static const int MAX_SIDE = 15;  ///< Largest supported side
+
+private:
+    int side;                                          ///< Cells per row and column
+    int cells;                                         ///< side * side
+    unsigned char to[TRANSFORMS][MAX_SIDE * MAX_SIDE];   ///< Image of each cell
+    unsigned char from[TRANSFORMS][MAX_SIDE * MAX_SIDE]; ///< Cell whose image each cell is
+    unsigned char inverses[TRANSFORMS];                ///< Transform undoing each one
+    unsigned char products[TRANSFORMS][TRANSFORMS];    ///< products[a][b]: b, then a
+
+    /** @brief Image of (x, y) under @p t on an @p n x @p n board, computed directly. */
+    static void transform(int n, int t, int x, int y, int& tx, int& ty) {
+        if (t & 4)
+            y = n - 1 - y;
+        for (int r = 0; r < (t & 3); ++r) {
+            int turned = n - 1 - x;
+            x = y;
+            y = turned;
+        }
+        tx = x;
+        ty = y;
+    }
+
+public:
+    /** @brief Build the tables of a @p n x @p n board (1 <= n <= MAX_SIDE). */
+    explicit SquareSymmetry(int n) : side(n), cells(n * n) {
+        for (int t = 0; t < TRANSFORMS; ++t)
+            for (int x = 0; x < side; ++x)
+                for (int y = 0; y < side; ++y) {
+                    int tx, ty;
+                    transform(side, t, x, y, tx, ty);
+                    to[t][x * side + y] = static_cast<unsigned char>(tx * side + ty);
+                    from[t][tx * side + ty] = static_cast<unsigned char>(x * side + y);
+                }
+
+        // Products are read off a 3 x 3 board, where all eight transforms
+        // differ, so smaller boards get the same group tables.
+        for (int a = 0; a < TRANSFORMS; ++a)
+            for (int b = 0; b < TRANSFORMS; ++b)
+                for (int c = 0; c < TRANSFORMS; ++c) {
+                    bool same = true;
+                    for (int x = 0; x < 3 && same; ++x)
+                        for (int y = 0; y < 3 && same; ++y) {
+                            int bx, by, abx, aby, cx, cy;
+                            transform(3, b, x, y, bx, by);
+                            transform(3, a, bx, by, abx, aby);
+                            transform(3, c, x, y, cx, cy);
+                            same = abx == cx && aby == cy;
+                        }
+                    if (same) {
+                        products[a][b] = static_cast<unsigned char>(c);
+                        if (c == 0)
+                            inverses[a] = static_cast<unsigned char>(b);
+                        break;
+                    }
+                }
+    }
+
+    /** @brief Tables of an N x N board, built on first use. */
+    template <int N>
+    static const SquareSymmetry& of() {
+        static const SquareSymmetry table(N);
+        return table;
+    }
+
+    /** @brief Cells per row and column. */
+    int get_side() const { return side; }
+
+    /** @brief Where cell @p cell goes under transform @p t. */
+    int map(int t, int cell) const { return to[t][cell]; }
+
+    /** @brief Which cell goes to @p cell under transform @p t. */
+    int source(int t, int cell) const { return from[t][cell]; }
+
+    /** @brief Transform that undoes @p t. */
+    int inverse(int t) const { return inverses[t]; }
+
+    /** @brief Transform doing @p first, then @p second. */
+    int compose(int second, int first) const { return products[second][first]; }
+
+    /** @brief Write the image of @p in under @p t to @p out (they must not overlap). */
+    template <typename T>
+    void apply(int t, const T* in, T* out) const {
+        for (int i = 0; i < cells; ++i)
+            out[to[t][i]] = in[i];
+    }
+
+    /**
+     * @brief Find the canonical image of @p in: the least of its eight
+     *        images in row-major lexicographic order.
+     *
+     * Images are compared cell by cell straight from @p in, stopping at
+     * the first difference, so most positions cost a few lookups per
+     * transform.
+     *
+     * @param out If given, receives the canonical image.
+     * @return The transform taking @p in to its canonical image (the
+     *         lowest one if several do).
+     */
+    template <typename T>
+    int canonical(const T* in, T* out = nullptr) const {
+        int best = 0;
+        for (int t = 1; t < TRANSFORMS; ++t)
+            for (int i = 0; i < cells; ++i) {
+                const T& a = in[from[t][i]];
+                const T& b = in[from[best][i]];
+                if (a < b) {
+                    best = t;
+                    break;
+                }
+                if (b < a)
+                    break;
+            }
+        if (out)
+            apply(best, in, out);
+        return best;
+    }
+};
+
+#endif // _BOARDGAME_SYMMETRY_H
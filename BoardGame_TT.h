@@ -0,0 +1,364 @@
+/**
+ * @file BoardGame_TT.h
+ * @brief Lock-free transposition table shared by search threads.
+ *
+ * A search meets the same position through different move orders; the
+ * table remembers what it learnt about each one (score, bound, depth and
+ * best move), keyed by Board::get_hash(). It is a fixed array of buckets,
+ * one cache line each, that any number of threads read and write without
+ * locks.
+ */
+
+#ifndef _BOARDGAME_TT_H
+#define _BOARDGAME_TT_H
+
+#include <atomic>
+#include <cstddef>
+#include <climits>
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+using namespace std;
+
+/// What the score of a table entry says about the true score.
+enum TTBound : unsigned {
+    TT_NONE = 0,   ///< No entry
+    TT_UPPER = 1,  ///< The true score is at most the stored one (no move reached alpha)
+    TT_LOWER = 2,  ///< The true score is at least the stored one (a move reached beta)
+    TT_EXACT = 3   ///< The stored score is exact
+};
+
+/**
+ * @brief Decoded transposition table entry.
+ */
+struct TTEntry {
+    int score = 0;           ///< Score for the side to move
+    int depth = 0;           ///< Plies searched below the position
+    TTBound bound = TT_NONE; ///< Meaning of @c score
+    int move = -1;           ///< Index of the best move in generate_moves order, -1 if none
+    int age = 0;             ///< Search (modulo 256) that stored the entry
+};
+
+/**
+ * @brief Table counters.
+ *
+ * Each search counts in its own TTStats and adds them to the table's
+ * totals when it ends, so threads do not fight over shared counters.
+ */
+struct TTStats {
+    long long probes = 0;     ///< Lookups
+    long long hits = 0;       ///< Lookups that found the position
+    long long stores = 0;     ///< Entries written
+    long long collisions = 0; ///< Stores that evicted another position of the current search
+
+    TTStats& operator+=(const TTStats& other) {
+        probes += other.probes;
+        hits += other.hits;
+        stores += other.stores;
+        collisions += other.collisions;
+        return *this;
+    }
+
+    /** @brief Fraction of lookups that found the position. */
+    double hit_rate() const { return probes ? double(hits) / probes : 0.0; }
+};
+
+//-----------------------------------------------------
+/**
+ * @brief Fixed-size transposition table with lock-free entries.
+ *
+ * Entries are two 64-bit words: the packed data and the key XORed with
+ * the data. A writer stores both words without a lock; a reader accepts
+ * an entry only if the two words XOR back to its key, so an entry torn by
+ * two threads writing at once reads as a miss instead of as wrong data.
+ *
+ * Four entries make a 64-byte bucket, aligned to a cache line, and a key
+ * selects one bucket. A store replaces the entry of the same position if
+ * present, otherwise an empty entry, otherwise the one with the lowest
+ * depth, entries from earlier searches (see new_search) counting as much
+ * shallower.
+ *
+ * The best move is kept as its index in the board's generate_moves order,
+ * so the table works for any move type; callers must check the index.
+ */
+class TranspositionTable {
+public:
+    static const int BUCKET_ENTRIES = 4; ///< Entries per 64-byte bucket
+    static const int MAX_MOVE = 1022;    ///< Largest move index an entry can hold
+
+private:
+    /** @brief One entry: the data and the key XOR the data. */
+    struct Slot {
+        atomic<unsigned long long> check{ 0 }; ///< Key ^ data
+        atomic<unsigned long long> data{ 0 };  ///< Packed TTEntry (0: empty)
+    };
+
+    /** @brief Entries sharing one cache line. */
+    struct alignas(64) Bucket {
+        Slot slots[BUCKET_ENTRIES];
+    };
+
+    Bucket* buckets = nullptr;      ///< The table
+    size_t n_buckets = 0;           ///< Number of buckets, a power of two
+    size_t bytes = 0;               ///< Bytes mapped
+    bool huge = false;              ///< Whether the table sits on huge pages
+    unsigned age = 0;               ///< Current search, modulo 256
+    atomic<long long> totals[4];    ///< Probes, hits, stores and collisions
+
+    static const int SCORE_BITS = 24; ///< Bits of the stored score
+
+    static unsigned long long pack(int score, int depth, TTBound bound, int move, unsigned age) {
+        return (static_cast<unsigned long long>(score + (1 << (SCORE_BITS - 1))) & 0xFFFFFF) |
+               static_cast<unsigned long long>(depth & 0xFF) << 24 |
+               static_cast<unsigned long long>(bound & 3) << 32 |
+               static_cast<unsigned long long>(age & 0xFF) << 34 |
+               static_cast<unsigned long long>((move + 1) & 0x3FF) << 42;
+    }
+
+    static TTEntry unpack(unsigned long long data) {
+        TTEntry entry;
+        entry.score = static_cast<int>(data & 0xFFFFFF) - (1 << (SCORE_BITS - 1));
+        entry.depth = static_cast<int>(data >> 24 & 0xFF);
+        entry.bound = static_cast<TTBound>(data >> 32 & 3);
+        entry.age = static_cast<int>(data >> 34 & 0xFF);
+        entry.move = static_cast<int>(data >> 42 & 0x3FF) - 1;
+        return entry;
+    }
+
+    /** @brief Map @p size bytes, on huge pages if asked and possible. */
+    void* map(size_t size, bool huge_pages) {
+#ifdef _WIN32
+        if (huge_pages) {
+            SIZE_T page = GetLargePageMinimum();
+            if (page && size % page == 0) {
+                void* p = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+                if (p) {
+                    huge = true;
+                    return p;
+                }
+            }
+        }
+        return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+#ifdef MAP_HUGETLB
+        if (huge_pages) {
+            void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p != MAP_FAILED) {
+                huge = true;
+                return p;
+            }
+        }
+#endif
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+            return nullptr;
+#ifdef MADV_HUGEPAGE
+        if (huge_pages && madvise(p, size, MADV_HUGEPAGE) == 0)
+            huge = true;
+#endif
+        return p;
+#endif
+    }
+
+    void unmap() {
+        if (!buckets) return;
+#ifdef _WIN32
+        VirtualFree(buckets, 0, MEM_RELEASE);
+#else
+        munmap(buckets, bytes);
+#endif
+        buckets = nullptr;
+        n_buckets = 0;
+        bytes = 0;
+        huge = false;
+    }
+
+public:
+    /**
+     * @brief Construct a table of at most @p megabytes MB (rounded down to
+     *        a power of two of buckets, at least one).
+     *
+     * @param huge_pages Back the table with huge pages where the system
+     *        allows it (explicit huge pages first, then transparent ones
+     *        on Linux; large pages on Windows, which need the "lock pages
+     *        in memory" privilege). Falls back to normal pages silently.
+     */
+    explicit TranspositionTable(size_t megabytes = 16, bool huge_pages = false) {
+        for (atomic<long long>& total : totals)
+            total.store(0, memory_order_relaxed);
+        resize(megabytes, huge_pages);
+    }
+
+    ~TranspositionTable() { unmap(); }
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    /**
+     * @brief Replace the table with an empty one of @p megabytes MB.
+     *
+     * Must not be called while a search uses the table.
+     * @return false if the memory could not be mapped (the table is then empty).
+     */
+    bool resize(size_t megabytes, bool huge_pages = false) {
+        unmap();
+        size_t count = 1;
+        while (count * 2 * sizeof(Bucket) <= megabytes * 1024 * 1024)
+            count *= 2;
+        void* memory = map(count * sizeof(Bucket), huge_pages);
+        if (!memory)
+            return false;
+        buckets = static_cast<Bucket*>(memory);
+        for (size_t i = 0; i < count; ++i)
+            new (&buckets[i]) Bucket();
+        n_buckets = count;
+        bytes = count * sizeof(Bucket);
+        return true;
+    }
+
+    /** @brief Forget every entry. Must not be called while a search uses the table. */
+    void clear() {
+        for (size_t i = 0; i < n_buckets; ++i)
+            for (Slot& slot : buckets[i].slots) {
+                slot.check.store(0, memory_order_relaxed);
+                slot.data.store(0, memory_order_relaxed);
+            }
+    }
+
+    /**
+     * @brief Start a new search: entries stored from now on are preferred
+     *        over older ones when a bucket is full.
+     */
+    void new_search() { age = (age + 1) & 0xFF; }
+
+    /**
+     * @brief Look up @p key.
+     * @return true and the entry in @p entry if the position is in the table.
+     */
+    bool probe(unsigned long long key, TTEntry& entry, TTStats& stats) const {
+        ++stats.probes;
+        if (!n_buckets) return false;
+        const Bucket& bucket = buckets[key & (n_buckets - 1)];
+        for (const Slot& slot : bucket.slots) {
+            unsigned long long data = slot.data.load(memory_order_relaxed);
+            if (data && (slot.check.load(memory_order_relaxed) ^ data) == key) {
+                entry = unpack(data);
+                ++stats.hits;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Remember what a search found about position @p key.
+     *
+     * A shallower non-exact result does not replace a deeper entry of the
+     * same position from the current search, and a result without a best
+     * move keeps the one already stored.
+     *
+     * @param score Score for the side to move, within +-2^23.
+     * @param depth Plies searched below the position (0 to 255).
+     * @param move Index of the best move in generate_moves order, -1 if
+     *        none; indices above MAX_MOVE are stored as none.
+     */
+    void store(unsigned long long key, int score, int depth, TTBound bound, int move, TTStats& stats) {
+        if (!n_buckets) return;
+        if (move > MAX_MOVE)
+            move = -1;
+        Bucket& bucket = buckets[key & (n_buckets - 1)];
+        Slot* victim = nullptr;
+        int victim_value = INT_MAX;
+        bool evicts = false;
+        for (Slot& slot : bucket.slots) {
+            unsigned long long data = slot.data.load(memory_order_relaxed);
+            if (!data) {
+                if (!victim || victim_value > INT_MIN) {
+                    victim = &slot;
+                    victim_value = INT_MIN;
+                    evicts = false;
+                }
+                continue;
+            }
+            TTEntry old = unpack(data);
+            if ((slot.check.load(memory_order_relaxed) ^ data) == key) {
+                if (bound != TT_EXACT && old.age == static_cast<int>(age) && old.depth > depth)
+                    return;
+                if (move < 0)
+                    move = old.move;
+                victim = &slot;
+                evicts = false;
+                break;
+            }
+            int stale = (age - old.age) & 0xFF;
+            int value = old.depth - 8 * stale;
+            if (value < victim_value) {
+                victim = &slot;
+                victim_value = value;
+                evicts = stale == 0;
+            }
+        }
+
+        unsigned long long data = pack(score, depth, bound, move, age);
+        victim->data.store(data, memory_order_relaxed);
+        victim->check.store(key ^ data, memory_order_relaxed);
+        ++stats.stores;
+        if (evicts) ++stats.collisions;
+    }
+
+    /** @brief Add a search's counters to the table's totals. */
+    void add_stats(const TTStats& stats) {
+        totals[0].fetch_add(stats.probes, memory_order_relaxed);
+        totals[1].fetch_add(stats.hits, memory_order_relaxed);
+        totals[2].fetch_add(stats.stores, memory_order_relaxed);
+        totals[3].fetch_add(stats.collisions, memory_order_relaxed);
+    }
+
+    /** @brief Counters added by every search so far. */
+    TTStats get_stats() const {
+        TTStats stats;
+        stats.probes = totals[0].load(memory_order_relaxed);
+        stats.hits = totals[1].load(memory_order_relaxed);
+        stats.stores = totals[2].load(memory_order_relaxed);
+        stats.collisions = totals[3].load(memory_order_relaxed);
+        return stats;
+    }
+
+    /** @brief Zero the counters. */
+    void reset_stats() {
+        for (atomic<long long>& total : totals)
+            total.store(0, memory_order_relaxed);
+    }
+
+    /**
+     * @brief Fraction of the first (up to) 1000 buckets' entries written
+     *        by the current search, an estimate of how full the table is.
+     */
+    double usage() const {
+        size_t sample = n_buckets < 1000 ? n_buckets : 1000;
+        long long used = 0;
+        for (size_t i = 0; i < sample; ++i)
+            for (const Slot& slot : buckets[i].slots) {
+                unsigned long long data = slot.data.load(memory_order_relaxed);
+                if (data && unpack(data).age == static_cast<int>(age))
+                    ++used;
+            }
+        return sample ? double(used) / (sample * BUCKET_ENTRIES) : 0.0;
+    }
+
+    /** @brief Number of entries. */
+    size_t get_entries() const { return n_buckets * BUCKET_ENTRIES; }
+
+    /** @brief Size of the table in bytes. */
+    size_t get_bytes() const { return bytes; }
+
+    /** @brief Whether the table is backed by huge pages. */
+    bool uses_huge_pages() const { return huge; }
+};
+
+#endif // _BOARDGAME_TT_H
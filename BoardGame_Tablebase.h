@@ -0,0 +1,780 @@
+/**
+ * @file BoardGame_Tablebase.h
+ * @brief Tablebases: variants solved by retrograde analysis, stored in a
+ *        file that engines map into memory and probe in O(1).
+ *
+ * Variants small enough to number all their positions (see
+ * Board::position_count) are solved outright by working backward from
+ * the end of the game: positions whose game is over are decided first,
+ * then, pass after pass, a position with a move to a lost position is
+ * won and a position whose moves all lead to won positions is lost,
+ * until a pass decides nothing more; the positions left are draws. Each
+ * position gets its value for the side to move and the number of plies
+ * to the end of the game with best play.
+ *
+ * A tablebase file is a header followed by one entry per position, in
+ * index order:
+ * @code
+ * header  'B' 'G' 'T' 'B' version entry_bytes 0 0
+ *         positions (8 bytes)  largest distance (4 bytes)  variant id (4 bytes)
+ *         checksum (8 bytes)  variant name (32 bytes, zero padded)
+ * entry   result << 14 | distance (2 bytes)
+ * @endcode
+ * Numbers are little-endian; the checksum is the 64-bit FNV-1a hash of
+ * the entries, and the variant id (see tb_variant_id) lets a reader
+ * refuse to probe a board of another variant whose index has the same
+ * size. The file holds nothing that depends on the time or on the
+ * number of threads, so solving a variant again gives the same bytes.
+ */
+
+#ifndef _BOARDGAME_TABLEBASE_H
+#define _BOARDGAME_TABLEBASE_H
+
+#include "BoardGame_Classes.h"
+
+#include <cstdio>
+#include <climits>
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const unsigned char TABLEBASE_MAGIC[4] = { 'B', 'G', 'T', 'B' }; ///< First bytes of a tablebase
+const int TABLEBASE_VERSION = 2;    ///< Format written by TablebaseGenerator
+const int TABLEBASE_HEADER = 64;    ///< Bytes in the file header
+const int TABLEBASE_ENTRY = 2;      ///< Bytes per position
+const int TABLEBASE_NAME = 32;      ///< Bytes of the variant name in the header
+const int TB_MAX_DISTANCE = 0x3FFF; ///< Longest distance an entry can hold
+
+/// Value of a position for the side to move.
+enum TBResult : unsigned {
+    TB_NONE = 0,  ///< Not a position of the game, or not covered by the table
+    TB_WIN = 1,   ///< The side to move wins
+    TB_LOSS = 2,  ///< The side to move loses
+    TB_DRAW = 3   ///< Neither side can force a win
+};
+
+/**
+ * @brief Decoded tablebase entry.
+ */
+struct TBEntry {
+    TBResult result = TB_NONE; ///< Value for the side to move
+    int distance = 0;          ///< Plies to the end with best play: the winner hurries, the loser holds out (0 for draws)
+};
+
+/** @brief Pack an entry into its 16-bit file form. */
+inline unsigned short tb_encode(TBResult result, int distance) {
+    return static_cast<unsigned short>(result << 14 | distance);
+}
+
+/** @brief Unpack an entry packed by tb_encode. */
+inline TBEntry tb_decode(unsigned short value) {
+    TBEntry entry;
+    entry.result = static_cast<TBResult>(value >> 14);
+    entry.distance = value & TB_MAX_DISTANCE;
+    return entry;
+}
+
+/** @brief 64-bit FNV-1a hash of @p size bytes. */
+inline unsigned long long tb_checksum(const unsigned char* bytes, size_t size) {
+    unsigned long long hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Identifier of the variant of @p board, stored in tablebase headers.
+ *
+ * Taken from the board's Zobrist keys, which each variant generates from
+ * its own seed; 0 for boards that are not hashed.
+ */
+template <typename BoardT>
+unsigned tb_variant_id(const BoardT& board) {
+    const ZobristTable* keys = board.get_zobrist_table();
+    return keys ? static_cast<unsigned>((keys->cell_key(0, 0) ^ keys->side_key()) >> 32) : 0;
+}
+
+//-----------------------------------------------------
+// Ranking functions for perfect indexes.
+
+/** @brief Binomial coefficient C(n, k); 0 unless 0 <= k <= n. */
+inline long long binomial(int n, int k) {
+    if (k < 0 || k > n) return 0;
+    long long result = 1;
+    for (int i = 1; i <= k; ++i)
+        result = result * (n - k + i) / i;
+    return result;
+}
+
+/** @brief Number of ways to pick @p k of @p n items in order, n! / (n - k)!. */
+inline long long arrangements(int n, int k) {
+    long long result = 1;
+    for (int i = 0; i < k; ++i)
+        result *= n - i;
+    return result;
+}
+
+/**
+ * @brief Rank of the set @p items (@p k ascending numbers) in
+ *        colexicographic order: 0 to C(n, k) - 1 over the k-sets of
+ *        0 to n - 1, whatever n.
+ */
+inline long long rank_subset(const int* items, int k) {
+    long long rank = 0;
+    for (int i = 0; i < k; ++i)
+        rank += binomial(items[i], i + 1);
+    return rank;
+}
+
+/** @brief Inverse of rank_subset: the @p k-set of 0 to @p n - 1 ranked @p rank, ascending. */
+inline void unrank_subset(long long rank, int n, int k, int* items) {
+    int item = n;
+    for (int i = k - 1; i >= 0; --i) {
+        do --item; while (binomial(item, i + 1) > rank);
+        items[i] = item;
+        rank -= binomial(item, i + 1);
+    }
+}
+
+/**
+ * @brief Rank of the sequence @p items of @p k distinct numbers from 0 to
+ *        @p n - 1 (n <= 64), from 0 to arrangements(n, k) - 1.
+ */
+inline long long rank_arrangement(const int* items, int k, int n) {
+    long long rank = 0;
+    for (int i = 0; i < k; ++i) {
+        int digit = items[i];
+        for (int j = 0; j < i; ++j)
+            if (items[j] < items[i]) --digit;
+        rank = rank * (n - i) + digit;
+    }
+    return rank;
+}
+
+/** @brief Inverse of rank_arrangement. */
+inline void unrank_arrangement(long long rank, int k, int n, int* items) {
+    for (int i = k - 1; i >= 0; --i) {
+        items[i] = static_cast<int>(rank % (n - i));
+        rank /= n - i;
+    }
+    unsigned long long used = 0;
+    for (int i = 0; i < k; ++i) {
+        int item = -1;
+        for (int skip = items[i]; skip >= 0; )
+            if (!((used >> ++item) & 1)) --skip;
+        used |= 1ULL << item;
+        items[i] = item;
+    }
+}
+
+/**
+ * @brief Rank of a placement of @p first pieces of one side and
+ *        @p second of the other on @p n cells (n <= 64), from 0 to
+ *        C(n, first) * C(n - first, second) - 1.
+ *
+ * @param owner Per cell: 0 empty, 1 first side, 2 second side.
+ * @return The rank, or -1 if the piece counts differ.
+ */
+inline long long rank_placement(const unsigned char* owner, int n, int first, int second) {
+    int ones[64], twos[64], a = 0, b = 0, free = 0;
+    for (int i = 0; i < n; ++i) {
+        if (owner[i] == 1) {
+            if (a == first) return -1;
+            ones[a++] = i;
+            continue;
+        }
+        if (owner[i] == 2) {
+            if (b == second) return -1;
+            twos[b++] = free; // numbered among the cells the first side left
+        }
+        ++free;
+    }
+    if (a != first || b != second) return -1;
+    return rank_subset(ones, first) * binomial(n - first, second) + rank_subset(twos, second);
+}
+
+/** @brief Inverse of rank_placement. */
+inline void unrank_placement(long long rank, int n, int first, int second, unsigned char* owner) {
+    long long seconds = binomial(n - first, second);
+    int ones[64], twos[64];
+    unrank_subset(rank / seconds, n, first, ones);
+    unrank_subset(rank % seconds, n - first, second, twos);
+    int a = 0, b = 0, free = 0;
+    for (int i = 0; i < n; ++i) {
+        if (a < first && ones[a] == i) {
+            owner[i] = 1;
+            ++a;
+            continue;
+        }
+        owner[i] = 0;
+        if (b < second && twos[b] == free) {
+            owner[i] = 2;
+            ++b;
+        }
+        ++free;
+    }
+}
+
+//-----------------------------------------------------
+/**
+ * @brief Solves a variant with a perfect index by retrograde analysis.
+ *
+ * @tparam BoardT Concrete board type; each worker plays on its own copy.
+ *
+ * Positions are handled in chunks of CHUNK that the worker threads take
+ * in turn, in two stages:
+ *  - Every position is set up with Board::set_position and its moves
+ *    played. Games already over, moves that win at once and positions
+ *    without a move to another position are decided there; the other
+ *    positions keep the indexes their moves lead to, 4 bytes per move.
+ *  - Then, pass after pass, a position with a move to a lost position is
+ *    won, one ply later than the quickest such loss, and a position
+ *    whose moves all lead to won positions, none drawing at once, is
+ *    lost, one ply later than the slowest of those wins. Each pass only
+ *    reads what earlier passes decided; its results are applied once all
+ *    workers are done.
+ * No entry depends on which thread worked it out, so the table is the
+ * same whatever the number of threads.
+ *
+ * Games are judged as GameManager does: after each move, is_win, is_lose
+ * and is_draw are asked of the player who moved. A position in which the
+ * player who moved last has won is lost, at distance 0, for the side to
+ * move; one in which the side to move has already won cannot arise (the
+ * game would have ended) and is left TB_NONE, as are indexes that
+ * set_position rejects.
+ */
+template <typename BoardT>
+class TablebaseGenerator {
+public:
+    typedef typename BoardT::cell_type T;
+    static const long long CHUNK = 1 << 14; ///< Positions per work item
+
+private:
+    /// Flags of a position still being solved.
+    enum : unsigned char {
+        UNDECIDED = 1, ///< Neither won nor lost yet
+        CAN_DRAW = 2   ///< Has a move that draws at once, so cannot be lost
+    };
+
+    const BoardT& prototype;           ///< Board of the variant, copied by each worker
+    Player<T>* players[2];             ///< First and second player
+    int threads;                       ///< Workers
+    long long count = 0;               ///< Positions in the index
+    vector<unsigned short> values;     ///< tb_encode entry of each position
+    vector<unsigned char> flags;       ///< Flags of each position
+    vector<unsigned long long> first_child; ///< Start of each position's moves in children
+    vector<unsigned> children;         ///< Positions the moves of undecided positions lead to
+    int passes = 0;                    ///< Passes of the second stage
+    int max_distance = 0;              ///< Longest distance in the table
+    atomic<bool> too_long{ false };    ///< Set if a distance does not fit an entry
+
+    /** @brief Call @p work(board, chunk) for every chunk, spread over the workers. */
+    template <typename F>
+    void for_each_chunk(F&& work) {
+        long long chunks = (count + CHUNK - 1) / CHUNK;
+        atomic<long long> next{ 0 };
+        auto worker = [&]() {
+            BoardT board(prototype);
+            for (long long chunk; (chunk = next.fetch_add(1)) < chunks; )
+                work(board, chunk);
+        };
+        vector<thread> workers;
+        for (int i = 1; i < threads; ++i)
+            workers.emplace_back(worker);
+        worker();
+        for (thread& w : workers)
+            w.join();
+    }
+
+    /**
+     * @brief First stage for position @p index: decide it if its children
+     *        are not needed, else append them to @p out.
+     * @return Number of children appended.
+     */
+    unsigned expand(BoardT& board, long long index, vector<unsigned>& out) {
+        values[index] = tb_encode(TB_NONE, 0);
+        flags[index] = 0;
+        if (!board.set_position(index))
+            return 0;
+        int n = board.get_n_moves();
+        Player<T>* side = players[n % 2];
+        Player<T>* other = players[1 - n % 2];
+        if (board.is_win(other)) {
+            values[index] = tb_encode(TB_LOSS, 0);
+            return 0;
+        }
+        if (board.is_lose(other)) {
+            values[index] = tb_encode(TB_WIN, 0);
+            return 0;
+        }
+        if (board.is_win(side))
+            return 0;
+        if (board.is_draw(other)) {
+            values[index] = tb_encode(TB_DRAW, 0);
+            return 0;
+        }
+
+        MoveList<T> moves;
+        board.generate_moves(side, moves);
+        size_t start = out.size();
+        bool drawing = false, losing = false;
+        for (int i = 0; i < moves.size(); ++i) {
+            if (!board.make_move(moves[i]))
+                continue;
+            bool won = board.is_win(side);
+            if (!won) {
+                if (board.is_lose(side))
+                    losing = true;
+                else if (board.is_draw(side))
+                    drawing = true;
+                else {
+                    long long child = board.position_index();
+                    if (child >= 0 && child < count)
+                        out.push_back(static_cast<unsigned>(child));
+                    else
+                        drawing = true; // leaves the index: not counted on
+                }
+            }
+            board.unmake_move();
+            if (won) {
+                out.resize(start);
+                values[index] = tb_encode(TB_WIN, 1);
+                return 0;
+            }
+        }
+
+        unsigned added = static_cast<unsigned>(out.size() - start);
+        if (added == 0) {
+            // Only moves that end the game at once, or no move at all,
+            // which searches score as a draw.
+            values[index] = losing && !drawing ? tb_encode(TB_LOSS, 1) : tb_encode(TB_DRAW, 0);
+            return 0;
+        }
+        values[index] = tb_encode(TB_DRAW, 0);
+        flags[index] = UNDECIDED | (drawing ? CAN_DRAW : 0);
+        return added;
+    }
+
+    /**
+     * @brief Second-stage value of undecided position @p index from its
+     *        children, or 0 if it stays undecided.
+     */
+    unsigned short decide(long long index) {
+        int quickest_loss = INT_MAX, slowest_win = 0;
+        bool all_won = true;
+        for (unsigned long long e = first_child[index]; e < first_child[index + 1]; ++e) {
+            TBEntry child = tb_decode(values[children[e]]);
+            if (child.result == TB_LOSS)
+                quickest_loss = min(quickest_loss, child.distance);
+            else if (child.result == TB_WIN)
+                slowest_win = max(slowest_win, child.distance);
+            else
+                all_won = false;
+        }
+        int distance;
+        TBResult result;
+        if (quickest_loss != INT_MAX) {
+            result = TB_WIN;
+            distance = quickest_loss + 1;
+        }
+        else if (all_won && !(flags[index] & CAN_DRAW)) {
+            result = TB_LOSS;
+            distance = slowest_win + 1;
+        }
+        else
+            return 0;
+        if (distance > TB_MAX_DISTANCE) {
+            too_long.store(true, memory_order_relaxed);
+            return 0;
+        }
+        return tb_encode(result, distance);
+    }
+
+public:
+    /**
+     * @brief Prepare to solve the variant of @p board with @p threads
+     *        workers (0: one per core).
+     *
+     * @param players The two players, first mover first; only their
+     *        symbols are used, by the board's rules.
+     */
+    TablebaseGenerator(const BoardT& board, Player<T>* players[2], int threads = 0)
+        : prototype(board),
+          threads(threads > 0 ? threads : max(1, static_cast<int>(thread::hardware_concurrency()))) {
+        this->players[0] = players[0];
+        this->players[1] = players[1];
+    }
+
+    TablebaseGenerator(const TablebaseGenerator&) = delete;
+    TablebaseGenerator& operator=(const TablebaseGenerator&) = delete;
+
+    /**
+     * @brief Solve every position of the index.
+     * @return false if the variant has no index (or one of more than
+     *         2^32 positions), or a distance overflows TB_MAX_DISTANCE.
+     */
+    bool generate() {
+        count = prototype.position_count();
+        values.clear();
+        if (count <= 0 || count > 0xFFFFFFFFLL)
+            return false;
+        values.assign(count, 0);
+        flags.assign(count, 0);
+        first_child.assign(count + 1, 0);
+        too_long = false;
+
+        // First stage: each chunk keeps its own children, joined in chunk
+        // (thus position) order afterwards.
+        long long chunks = (count + CHUNK - 1) / CHUNK;
+        vector<vector<unsigned>> chunk_children(chunks);
+        for_each_chunk([&](BoardT& board, long long chunk) {
+            vector<unsigned>& out = chunk_children[chunk];
+            long long end = min(count, (chunk + 1) * CHUNK);
+            for (long long i = chunk * CHUNK; i < end; ++i)
+                first_child[i + 1] = expand(board, i, out);
+            out.shrink_to_fit();
+        });
+        for (long long i = 0; i < count; ++i)
+            first_child[i + 1] += first_child[i];
+        children.clear();
+        children.reserve(first_child[count]);
+        for (vector<unsigned>& out : chunk_children) {
+            children.insert(children.end(), out.begin(), out.end());
+            vector<unsigned>().swap(out);
+        }
+
+        // Second stage.
+        vector<vector<pair<unsigned, unsigned short>>> updates(chunks);
+        for (passes = 1; ; ++passes) {
+            for_each_chunk([&](BoardT&, long long chunk) {
+                vector<pair<unsigned, unsigned short>>& out = updates[chunk];
+                out.clear();
+                long long end = min(count, (chunk + 1) * CHUNK);
+                for (long long i = chunk * CHUNK; i < end; ++i)
+                    if (flags[i] & UNDECIDED)
+                        if (unsigned short value = decide(i))
+                            out.emplace_back(static_cast<unsigned>(i), value);
+            });
+            long long decided = 0;
+            for (const vector<pair<unsigned, unsigned short>>& out : updates)
+                for (const pair<unsigned, unsigned short>& update : out) {
+                    values[update.first] = update.second;
+                    flags[update.first] = 0;
+                    ++decided;
+                }
+            if (decided == 0 || too_long)
+                break;
+        }
+
+        vector<unsigned>().swap(children);
+        vector<unsigned long long>().swap(first_child);
+        vector<unsigned char>().swap(flags);
+        max_distance = 0;
+        for (unsigned short value : values)
+            max_distance = max(max_distance, tb_decode(value).distance);
+        if (too_long) {
+            values.clear();
+            return false;
+        }
+        return true;
+    }
+
+    /** @brief Positions in the index. */
+    long long get_count() const { return count; }
+
+    /** @brief Entry of position @p index (TB_NONE before generate). */
+    TBEntry get_entry(long long index) const {
+        return index >= 0 && index < static_cast<long long>(values.size()) ? tb_decode(values[index]) : TBEntry();
+    }
+
+    /** @brief Number of positions whose result is @p result. */
+    long long count_of(TBResult result) const {
+        long long total = 0;
+        for (unsigned short value : values)
+            if (tb_decode(value).result == result) ++total;
+        return total;
+    }
+
+    /** @brief Passes of the second stage of the last generation. */
+    int get_passes() const { return passes; }
+
+    /** @brief Longest distance in the table. */
+    int get_max_distance() const { return max_distance; }
+
+    /**
+     * @brief Write the table to @p path, tagged with the variant @p name
+     *        (cut to 31 bytes).
+     * @return false if nothing was generated or the file cannot be written.
+     */
+    bool save(const string& path, const string& name) const {
+        if (values.empty())
+            return false;
+        vector<unsigned char> bytes(TABLEBASE_HEADER + values.size() * TABLEBASE_ENTRY, 0);
+        unsigned char* entries = bytes.data() + TABLEBASE_HEADER;
+        for (size_t i = 0; i < values.size(); ++i) {
+            entries[2 * i] = static_cast<unsigned char>(values[i]);
+            entries[2 * i + 1] = static_cast<unsigned char>(values[i] >> 8);
+        }
+        unsigned long long checksum = tb_checksum(entries, values.size() * TABLEBASE_ENTRY);
+
+        unsigned char* header = bytes.data();
+        memcpy(header, TABLEBASE_MAGIC, 4);
+        header[4] = TABLEBASE_VERSION;
+        header[5] = TABLEBASE_ENTRY;
+        for (int b = 0; b < 8; ++b) {
+            header[8 + b] = static_cast<unsigned char>(static_cast<unsigned long long>(count) >> (8 * b));
+            header[24 + b] = static_cast<unsigned char>(checksum >> (8 * b));
+        }
+        unsigned variant = tb_variant_id(prototype);
+        for (int b = 0; b < 4; ++b) {
+            header[16 + b] = static_cast<unsigned char>(max_distance >> (8 * b));
+            header[20 + b] = static_cast<unsigned char>(variant >> (8 * b));
+        }
+        memcpy(header + 32, name.data(), min(name.size(), static_cast<size_t>(TABLEBASE_NAME - 1)));
+
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file) return false;
+        bool written = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+        return fclose(file) == 0 && written;
+    }
+};
+
+//-----------------------------------------------------
+/**
+ * @brief A tablebase file mapped read-only into memory.
+ *
+ * A probe reads the two bytes of one entry straight from the mapping, so
+ * it costs one (possibly cold) memory access; the OS pages the file in
+ * as it is probed and any number of threads and processes share it.
+ */
+class Tablebase {
+    const unsigned char* bytes = nullptr; ///< Mapped file, nullptr if none
+    size_t length = 0;                    ///< Bytes mapped
+    long long count = 0;                  ///< Positions in the table
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;   ///< Open tablebase
+    HANDLE mapping = nullptr;             ///< Mapping of the tablebase
+#endif
+
+    /** @brief Little-endian number of @p size bytes at header offset @p at. */
+    unsigned long long header_value(int at, int size) const {
+        unsigned long long value = 0;
+        for (int b = 0; b < size; ++b)
+            value |= static_cast<unsigned long long>(bytes[at + b]) << (8 * b);
+        return value;
+    }
+
+public:
+    Tablebase() {}
+    ~Tablebase() { close(); }
+
+    Tablebase(const Tablebase&) = delete;
+    Tablebase& operator=(const Tablebase&) = delete;
+
+    /**
+     * @brief Map @p path.
+     * @return false if the file cannot be mapped, is not a tablebase or is
+     *         cut short.
+     */
+    bool open(const string& path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart < TABLEBASE_HEADER) {
+            close();
+            return false;
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!view) {
+            close();
+            return false;
+        }
+        bytes = static_cast<const unsigned char*>(view);
+        length = static_cast<size_t>(size.QuadPart);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < TABLEBASE_HEADER) {
+            ::close(fd);
+            return false;
+        }
+        void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) return false;
+        madvise(view, static_cast<size_t>(info.st_size), MADV_RANDOM);
+        bytes = static_cast<const unsigned char*>(view);
+        length = static_cast<size_t>(info.st_size);
+#endif
+        count = static_cast<long long>(header_value(8, 8));
+        if (memcmp(bytes, TABLEBASE_MAGIC, 4) != 0 || bytes[4] != TABLEBASE_VERSION ||
+            bytes[5] != TABLEBASE_ENTRY || count < 0 ||
+            static_cast<unsigned long long>(count) > (length - TABLEBASE_HEADER) / TABLEBASE_ENTRY ||
+            length != TABLEBASE_HEADER + static_cast<size_t>(count) * TABLEBASE_ENTRY) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    /** @brief Unmap the tablebase. */
+    void close() {
+#ifdef _WIN32
+        if (bytes) UnmapViewOfFile(bytes);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (bytes) munmap(const_cast<unsigned char*>(bytes), length);
+#endif
+        bytes = nullptr;
+        length = 0;
+        count = 0;
+    }
+
+    /** @brief Check whether a tablebase is mapped. */
+    bool is_open() const { return bytes != nullptr; }
+
+    /** @brief Positions in the table (0 if none is mapped). */
+    long long get_count() const { return count; }
+
+    /** @brief Variant name stored by the generator. */
+    string get_name() const {
+        if (!bytes) return string();
+        const char* name = reinterpret_cast<const char*>(bytes + 32);
+        return string(name, strnlen(name, TABLEBASE_NAME));
+    }
+
+    /** @brief Longest distance in the table. */
+    int get_max_distance() const { return bytes ? static_cast<int>(header_value(16, 4)) : 0; }
+
+    /** @brief Variant id stored by the generator (see tb_variant_id). */
+    unsigned get_variant_id() const { return bytes ? static_cast<unsigned>(header_value(20, 4)) : 0; }
+
+    /**
+     * @brief Check whether the table is of the variant of @p board: same
+     *        variant id and an index of the same size.
+     */
+    template <typename BoardT>
+    bool covers(const BoardT& board) const {
+        return bytes && board.position_count() == count && tb_variant_id(board) == get_variant_id();
+    }
+
+    /** @brief Checksum of the entries stored in the header. */
+    unsigned long long get_checksum() const { return bytes ? header_value(24, 8) : 0; }
+
+    /**
+     * @brief Check the entries against the stored checksum. Reads the
+     *        whole file.
+     */
+    bool verify() const {
+        return bytes && tb_checksum(bytes + TABLEBASE_HEADER, static_cast<size_t>(count) * TABLEBASE_ENTRY) ==
+                        get_checksum();
+    }
+
+    /** @brief Entry of position @p index; TB_NONE if outside the table. */
+    TBEntry probe(long long index) const {
+        if (index < 0 || index >= count)
+            return TBEntry();
+        const unsigned char* entry = bytes + TABLEBASE_HEADER + index * TABLEBASE_ENTRY;
+        return tb_decode(static_cast<unsigned short>(entry[0] | entry[1] << 8));
+    }
+
+    /**
+     * @brief Entry of the position on @p board; TB_NONE if the table is not
+     *        of the board's variant (see covers).
+     */
+    template <typename BoardT>
+    TBEntry probe(const BoardT& board) const {
+        if (!covers(board))
+            return TBEntry();
+        return probe(board.position_index());
+    }
+};
+
+//-----------------------------------------------------
+/**
+ * @brief Agent that plays perfectly from a tablebase of the variant.
+ *
+ * Each move is played on the board and the position it leads to probed:
+ * the agent wins as quickly as it can, draws if it cannot win, and
+ * otherwise loses as slowly as it can. Among equally good moves it plays
+ * the first generated. On boards the table does not cover it plays a
+ * random move.
+ */
+template <typename T>
+class TablebaseAgent final : public MoveAgent<T> {
+    const Tablebase& table; ///< Tablebase of the variant played
+    GameRandom* random;     ///< Generator for uncovered boards (nullptr: the thread's)
+
+    /** @brief Value for the mover of a move already played: wins high, quick wins higher. */
+    template <typename BoardT>
+    int value_of_move(BoardT& board, Player<T>* player) const {
+        const int WIN = TB_MAX_DISTANCE + 2;
+        if (board.is_win(player)) return WIN - 1;
+        if (board.is_lose(player)) return 1 - WIN;
+        if (board.is_draw(player)) return 0;
+        TBEntry reply = table.probe(board.position_index());
+        if (reply.result == TB_LOSS) return WIN - 1 - reply.distance;
+        if (reply.result == TB_WIN) return 1 + reply.distance - WIN;
+        return 0;
+    }
+
+    template <typename BoardT>
+    Move<T> pick(BoardT& board, Player<T>* player) {
+        MoveList<T> moves;
+        board.generate_moves(player, moves);
+        if (moves.empty())
+            return Move<T>(-1, -1, player->get_symbol());
+        if (!table.covers(board))
+            return moves[(random ? *random : thread_random()).below(moves.size())];
+
+        int best = 0, best_value = INT_MIN;
+        for (int i = 0; i < moves.size(); ++i) {
+            if (!board.make_move(moves[i]))
+                continue;
+            int value = value_of_move(board, player);
+            board.unmake_move();
+            if (value > best_value) {
+                best_value = value;
+                best = i;
+            }
+        }
+        return moves[best];
+    }
+
+public:
+    /** @brief Construct an agent probing @p tablebase (not owned). */
+    explicit TablebaseAgent(const Tablebase& tablebase, GameRandom* random = nullptr)
+        : table(tablebase), random(random) {}
+
+    Move<T> choose_move(Board<T>& board, Player<T>* player, const MoveBudget&) override {
+        return pick(board, player);
+    }
+
+    /**
+     * @brief choose_move for a board whose concrete type is known, so that
+     *        board calls are resolved at compile time.
+     */
+    template <typename BoardT>
+    Move<T> choose_move(BoardT& board, Player<T>* player) {
+        return pick(board, player);
+    }
+};
+
+#endif // _BOARDGAME_TABLEBASE_H
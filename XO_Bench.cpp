@@ -0,0 +1,381 @@
+/**
+ * @file XO_Bench.cpp
+ * @brief Micro-benchmarks for every X-O game variant.
+ *
+ * For each variant this file:
+ *  - Builds a seeded corpus of mid-game positions (random legal moves,
+ *    never a finished game)
+ *  - Measures ns/op of update_board, is_win, is_draw and game_is_over
+ *    on that corpus
+ *  - Measures random-playout throughput in games per second, both through
+ *    GameManager (virtual calls) and StaticGameManager (concrete board type)
+ *  - Measures the per-move cost of the MNKBoard engine from 6x6 to 19x19
+ *  - Measures how Monte Carlo tree search playouts scale with threads
+ *  - Reports how long iterative deepening takes to answer with a 5 ms
+ *    budget on every variant (99th percentile and worst), and how deep it
+ *    gets; the benchmark fails (exit code 1) if a search plays an illegal
+ *    move. Time is only reported, as one stall of the machine can hold up
+ *    any single search
+ *
+ * Usage:
+ * @code
+ * XO_Bench [seed] [positions] [playout_games]
+ * @endcode
+ *
+ * The same seed always gives the same corpus, so numbers from two builds
+ * can be compared directly.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <thread>
+#include <type_traits>
+#include <cstdlib>
+
+#include "BoardGame_Classes.h"
+#include "XO_Classes.h"
+#include "BoardGame_MNK.h"
+#include "BoardGame_MCTS.h"
+
+using namespace std;
+
+/// Passes over the corpus for each end-of-game check.
+const int CHECK_PASSES = 200;
+
+/// Passes over the corpus for update_board (each rebuilds the corpus).
+const int UPDATE_PASSES = 20;
+
+/**
+ * @brief Seeded set of mid-game positions of one variant.
+ */
+struct Corpus {
+    vector<unique_ptr<Board<char>>> boards;  ///< Positions, each on its own board
+    vector<Move<char>> next_moves;           ///< A legal move in each position
+    vector<int> movers;                      ///< Player who made the last move (0 or 1)
+};
+
+/**
+ * @brief Builds @p size positions of @p variant from @p seed.
+ *
+ * Each position is reached by up to 30 random legal moves. A move that
+ * would end the game is taken back, so every position is still in play.
+ */
+void build_corpus(int variant, unsigned long long seed, int size, Player<char>* players[2], Corpus& corpus) {
+    const XO_Variant& info = xo_variant(variant);
+    GameRandom& rng = thread_random();
+    rng.reseed(seed + variant);
+    corpus.boards.clear();
+    corpus.next_moves.clear();
+    corpus.movers.clear();
+
+    MoveList<char> moves;
+    while (static_cast<int>(corpus.boards.size()) < size) {
+        unique_ptr<Board<char>> board(info.create());
+        int target = 1 + rng.below(30);
+        int ply = 0;
+        for (; ply < target; ++ply) {
+            Player<char>* player = players[ply % 2];
+            board->generate_moves(player, moves);
+            if (moves.empty() || !board->make_move(moves[rng.below(moves.size())]))
+                break;
+            if (board->game_is_over(player) || board->is_win(player) ||
+                board->is_lose(player) || board->is_draw(player)) {
+                board->unmake_move();
+                break;
+            }
+        }
+        if (ply == 0)
+            continue;
+
+        board->generate_moves(players[ply % 2], moves);
+        if (moves.empty())
+            continue;
+        corpus.next_moves.push_back(moves[rng.below(moves.size())]);
+        corpus.movers.push_back((ply - 1) % 2);
+        corpus.boards.push_back(move(board));
+    }
+}
+
+/**
+ * @brief Times @p passes calls of @p check on every corpus position.
+ * @return Nanoseconds per call.
+ */
+template <typename Check>
+double time_check(Corpus& corpus, Player<char>* players[2], Check check) {
+    long long found = 0;
+    auto start = chrono::steady_clock::now();
+    for (int pass = 0; pass < CHECK_PASSES; ++pass)
+        for (size_t i = 0; i < corpus.boards.size(); ++i)
+            found += check(*corpus.boards[i], players[corpus.movers[i]]);
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+
+    // Positions are never finished, so a non-zero count means a bug.
+    if (found) cout << "  (warning: " << found << " finished positions)\n";
+    return ns / (static_cast<double>(CHECK_PASSES) * corpus.boards.size());
+}
+
+/**
+ * @brief Times update_board with each position's next move.
+ *
+ * The corpus is rebuilt (untimed) before every pass.
+ * @return Nanoseconds per call.
+ */
+double time_update(int variant, unsigned long long seed, int size, Player<char>* players[2], Corpus& corpus) {
+    double ns = 0;
+    long long applied = 0;
+    for (int pass = 0; pass < UPDATE_PASSES; ++pass) {
+        build_corpus(variant, seed, size, players, corpus);
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < corpus.boards.size(); ++i)
+            applied += corpus.boards[i]->update_board(corpus.next_moves[i]);
+        ns += chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    }
+    if (applied != static_cast<long long>(UPDATE_PASSES) * size)
+        cout << "  (warning: " << UPDATE_PASSES * size - applied << " moves rejected)\n";
+
+    // Leave the corpus in its original positions for the checks.
+    build_corpus(variant, seed, size, players, corpus);
+    return ns / (static_cast<double>(UPDATE_PASSES) * size);
+}
+
+/**
+ * @brief Plays @p games random games headless through GameManager.
+ * @return Games per second.
+ */
+double time_playouts(int variant, unsigned long long seed, int games, Player<char>* players[2]) {
+    const XO_Variant& info = xo_variant(variant);
+    GameRandom rng(seed ^ 0x5DEECE66DULL);
+    RandomAgent<char> agent(&rng);
+    MoveAgent<char>* agents[2] = { &agent, &agent };
+    GameRecord<char> record;
+
+    auto start = chrono::steady_clock::now();
+    for (int g = 0; g < games; ++g) {
+        unique_ptr<Board<char>> board(info.create());
+        board->set_random(&rng);
+        GameManager<char> game(board.get(), players);
+        game.run_headless(agents, record);
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return seconds > 0 ? games / seconds : 0;
+}
+
+/**
+ * @brief Plays the same games as time_playouts through StaticGameManager.
+ * @return Games per second.
+ */
+double time_static_playouts(int variant, unsigned long long seed, int games, Player<char>* players[2]) {
+    GameRandom rng(seed ^ 0x5DEECE66DULL);
+    RandomAgent<char> agent(&rng);
+    GameRecord<char> record;
+
+    auto start = chrono::steady_clock::now();
+    for (int g = 0; g < games; ++g) {
+        with_variant_board(variant, [&](auto& board) {
+            typedef typename decay<decltype(board)>::type BoardT;
+            board.set_random(&rng);
+            StaticGameManager<BoardT, RandomAgent<char>, RandomAgent<char>> game(board, players, agent, agent);
+            game.run(record);
+            });
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return seconds > 0 ? games / seconds : 0;
+}
+
+/**
+ * @brief Times random games of @p BoardT, move generation excluded.
+ *
+ * Each game is first played untimed to record its moves, then replayed
+ * on a fresh board with update_board, is_win and is_draw after each move.
+ * @return Nanoseconds per move.
+ */
+template <typename BoardT>
+double time_mnk_move(unsigned long long seed, int games) {
+    GameRandom rng(seed);
+    Player<char> first("Player 1", 'X', PlayerType::COMPUTER);
+    Player<char> second("Player 2", 'O', PlayerType::COMPUTER);
+    Player<char>* players[2] = { &first, &second };
+    vector<Move<char>> line;
+    MoveList<char> moves;
+
+    long long plies = 0, finished = 0;
+    double ns = 0;
+    for (int g = 0; g < games; ++g) {
+        BoardT scratch;
+        line.clear();
+        for (int ply = 0;; ++ply) {
+            Player<char>* player = players[ply % 2];
+            scratch.generate_moves(player, moves);
+            if (moves.empty()) break;
+            line.push_back(moves[rng.below(moves.size())]);
+            scratch.update_board(line.back());
+            if (scratch.is_win(player) || scratch.is_draw(player)) break;
+        }
+
+        BoardT board;
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < line.size(); ++i) {
+            Player<char>* player = players[i % 2];
+            board.update_board(line[i]);
+            finished += board.is_win(player) || board.is_draw(player);
+        }
+        ns += chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        plies += line.size();
+    }
+    if (finished != games) cout << "  (warning: " << games - finished << " replays did not end)\n";
+    return plies ? ns / plies : 0;
+}
+
+/**
+ * @brief Playouts per second of MCTSSearch with @p threads workers on the
+ *        opening of Ultimate X-O, searching for @p millis milliseconds.
+ */
+double time_mcts(int threads, unsigned long long seed, long long millis) {
+    GameRandom rng(seed);
+    Ultimate_X_O_Board board;
+    board.set_random(&rng);
+    Player<char> first("Player 1", 'X', PlayerType::AI);
+    Player<char> second("Player 2", 'O', PlayerType::AI);
+    MCTSSearch<char> engine(threads, 1 << 22);
+    MoveBudget budget;
+    budget.millis = millis;
+
+    auto start = chrono::steady_clock::now();
+    SearchResult<char> result = engine.search(board, &first, &second, budget, &rng);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return result.nodes / seconds;
+}
+
+/**
+ * @brief Searches every corpus position with NegamaxSearch for @p millis
+ *        milliseconds and a 16 MB transposition table.
+ *
+ * @param p99_ms Receives the 99th percentile of search time, in milliseconds.
+ * @param worst_ms Receives the longest search, in milliseconds.
+ * @param depth Receives the mean depth completed.
+ * @return Number of searches whose move the board rejected.
+ */
+int time_search(Corpus& corpus, Player<char>* players[2], long long millis,
+                double& p99_ms, double& worst_ms, double& depth) {
+    NegamaxSearch<char> engine;
+    TranspositionTable table(16);
+    engine.set_table(&table);
+    MoveBudget budget;
+    budget.millis = millis;
+
+    int illegal = 0;
+    long long depths = 0;
+    vector<double> times;
+    for (size_t i = 0; i < corpus.boards.size(); ++i) {
+        Board<char>& board = *corpus.boards[i];
+        Player<char>* side = players[1 - corpus.movers[i]];
+        Player<char>* other = players[corpus.movers[i]];
+        table.new_search();
+        auto start = chrono::steady_clock::now();
+        SearchResult<char> result = engine.search(board, side, other, budget);
+        times.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+        depths += result.depth;
+        if (board.make_move(result.move))
+            board.unmake_move();
+        else
+            ++illegal;
+    }
+    sort(times.begin(), times.end());
+    p99_ms = times.empty() ? 0.0 : times[(times.size() - 1) * 99 / 100];
+    worst_ms = times.empty() ? 0.0 : times.back();
+    depth = corpus.boards.empty() ? 0.0 : double(depths) / corpus.boards.size();
+    return illegal;
+}
+
+/**
+ * @brief Main function. Runs every benchmark for every variant.
+ *
+ * @return int 0 on success, 1 if a timed search played an illegal move.
+ */
+int main(int argc, char* argv[]) {
+    unsigned long long seed = argc > 1 ? strtoull(argv[1], nullptr, 10) : 12345;
+    int size = argc > 2 ? atoi(argv[2]) : 256;
+    int games = argc > 3 ? atoi(argv[3]) : 20000;
+    if (size < 1) size = 1;
+
+    cout << "seed " << seed << ", " << size << " positions, "
+         << games << " playouts per variant\n\n";
+    cout << left << setw(24) << "Variant" << right
+         << setw(14) << "update ns" << setw(12) << "is_win ns" << setw(12) << "is_draw ns"
+         << setw(12) << "over ns" << setw(14) << "games/s" << setw(14) << "static g/s" << "\n";
+
+    Corpus corpus;
+    for (int v = 0; v < XO_VARIANT_COUNT; ++v) {
+        const XO_Variant& info = xo_variant(v);
+        Player<char> first("Player 1", info.symbols[0], PlayerType::COMPUTER);
+        Player<char> second("Player 2", info.symbols[1], PlayerType::COMPUTER);
+        Player<char>* players[2] = { &first, &second };
+
+        double update_ns = time_update(v, seed, size, players, corpus);
+        double win_ns = time_check(corpus, players,
+            [](Board<char>& b, Player<char>* p) { return b.is_win(p); });
+        double draw_ns = time_check(corpus, players,
+            [](Board<char>& b, Player<char>* p) { return b.is_draw(p); });
+        double over_ns = time_check(corpus, players,
+            [](Board<char>& b, Player<char>* p) { return b.game_is_over(p); });
+        double per_second = time_playouts(v, seed, games, players);
+        double static_per_second = time_static_playouts(v, seed, games, players);
+
+        cout << left << setw(24) << info.name << right << fixed << setprecision(1)
+             << setw(14) << update_ns << setw(12) << win_ns << setw(12) << draw_ns
+             << setw(12) << over_ns << setw(14) << setprecision(0) << per_second
+             << setw(14) << static_per_second << "\n";
+    }
+
+    int mnk_games = max(1, games / 100);
+    cout << "\nMNKBoard engine, ns per move (update_board, is_win, is_draw), "
+         << mnk_games << " games each\n";
+    cout << left << setw(24) << "6 x 6, 4 in a row" << right << setw(14) << setprecision(1)
+         << time_mnk_move<MNKBoard<6, 6, 4>>(seed, mnk_games) << "\n";
+    cout << left << setw(24) << "6 x 7, 4, gravity" << right << setw(14)
+         << time_mnk_move<MNKBoard<6, 7, 4, MNK_GRAVITY>>(seed, mnk_games) << "\n";
+    cout << left << setw(24) << "15 x 15, 5 in a row" << right << setw(14)
+         << time_mnk_move<MNKBoard<15, 15, 5>>(seed, mnk_games) << "\n";
+    cout << left << setw(24) << "19 x 19, 5 in a row" << right << setw(14)
+         << time_mnk_move<MNKBoard<19, 19, 5>>(seed, mnk_games) << "\n";
+
+    // More workers than cores would only measure the scheduler.
+    int cores = max(1, static_cast<int>(thread::hardware_concurrency()));
+    cout << "\nMCTS on Ultimate X-O, 500 ms per search (" << cores << " cores)\n";
+    cout << left << setw(24) << "Threads" << right << setw(14) << "playouts/s" << setw(12) << "speed-up" << "\n";
+    double single = 0;
+    for (int threads = 1; threads <= min(cores, 32); threads *= 2) {
+        double per_second = time_mcts(threads, seed, 500);
+        if (threads == 1) single = per_second;
+        cout << left << setw(24) << threads << right << setw(14) << setprecision(0) << per_second
+             << setw(12) << setprecision(2) << per_second / single << "\n";
+    }
+
+    const long long search_millis = 5;
+    bool failed = false;
+    cout << "\nIterative deepening, " << search_millis << " ms per move, 64 positions per variant\n";
+    cout << left << setw(24) << "Variant" << right << setw(14) << "p99 ms" << setw(12) << "worst ms"
+         << setw(12) << "mean depth" << "\n";
+    for (int v = 0; v < XO_VARIANT_COUNT; ++v) {
+        const XO_Variant& info = xo_variant(v);
+        Player<char> first("Player 1", info.symbols[0], PlayerType::AI);
+        Player<char> second("Player 2", info.symbols[1], PlayerType::AI);
+        Player<char>* players[2] = { &first, &second };
+        build_corpus(v, seed, 64, players, corpus);
+
+        double p99_ms, worst_ms, depth;
+        int illegal = time_search(corpus, players, search_millis, p99_ms, worst_ms, depth);
+        cout << left << setw(24) << info.name << right << setw(14) << setprecision(2) << p99_ms
+             << setw(12) << worst_ms << setw(12) << setprecision(1) << depth;
+        if (p99_ms > search_millis) cout << "  (over budget)";
+        if (illegal) cout << "  (FAILED: " << illegal << " illegal moves)";
+        cout << "\n";
+        failed = failed || illegal;
+    }
+    return failed ? 1 : 0;
+}
@@ -24,6 +24,7 @@
 #include <queue>
 #include <utility>
 #include "XO_Classes.h"
+#include "BoardGame_Tablebase.h"
 #include <map>
 #include <algorithm>
 #include "dic.h"
@@ -79,15 +80,18 @@ Ultimate_X_O_UI::Ultimate_X_O_UI() : UI<char>("Welcome to Ultimate Tic Tac Toe!"
 
 //--------------------------------------- Infinty_X_O_Board Implementation
 
+/// Zobrist keys of Infinity X-O (plane 1 hashes the removal order).
+static const ZobristTable infinity_keys(9, 2, 1);
+
 /**
  * @brief Constructs a 3x3 infinity X-O board and clears all cells.
  *
  * The board starts empty and uses @c blank_symbol for all positions.
  */
-X_O_Board::X_O_Board() : Board(3, 3) {
-    for (auto& row : board)
-        for (auto& cell : row)
-            cell = blank_symbol;
+X_O_Board::X_O_Board() {
+    board.fill(blank_symbol);
+    init_hash(infinity_keys);
+    init_symmetry(SquareSymmetry::of<3>());
 }
 
 /**
@@ -96,73 +100,212 @@ X_O_Board::X_O_Board() : Board(3, 3) {
  * For this variant, only the last 6 moves remain on the board. When the
  * number of moves exceeds 6, the oldest move is removed.
  *
- * @param move Pointer to the move containing coordinates and symbol.
+ * @param move The move containing coordinates and symbol.
  * @return @c true if the move is valid and applied, otherwise @c false.
  */
-bool X_O_Board::update_board(Move<char>* move) {
-    int x = move->get_x();
-    int y = move->get_y();
-    char mark = move->get_symbol();
+bool X_O_Board::update_board(const Move<char>& move) {
+    int x = move.get_x();
+    int y = move.get_y();
+    char mark = move.get_symbol();
 
     // 1. Validate move logic
-    if (!(x < 0 || x >= rows || y < 0 || y >= columns) &&
-        (board[x][y] == blank_symbol || mark == 0)) {
+    if (x < 0 || x >= rows || y < 0 || y >= columns || board[x][y] != blank_symbol)
+        return false;
 
-        if (mark == 0) { // Undo move (optional, rarely used in this game type)
-            n_moves--;
-            board[x][y] = blank_symbol;
-        }
-        else {
-            // 2. Apply the new move
-            n_moves++;
-            board[x][y] = toupper(mark);
+    // 2. Apply the new move
+    n_moves++;
+    set_cell(x, y, toupper(mark));
+    set_last_move(x, y);
 
-            // 3. Add this VALID move to the internal queue
-            movelist.push({ x, y });
+    // 3. Add this VALID move to the internal queue
+    toggle_derived_hash();
+    movelist[(queue_head + queue_size) % 8] = x * columns + y;
+    queue_size++;
 
-            // 4. Infinity Logic: If more than 6 pieces (3 per player), remove the oldest
-            if (n_moves > 6) {
-                int a = movelist.front().first;
-                int b = movelist.front().second;
+    // 4. Infinity Logic: If more than 6 pieces (3 per player), remove the oldest
+    if (n_moves > 6) {
+        int oldest = movelist[queue_head];
 
-                // Clear the oldest piece
-                board[a][b] = blank_symbol;
+        // Clear the oldest piece
+        set_cell(oldest / columns, oldest % columns, blank_symbol);
 
-                // Remove it from the queue history
-                movelist.pop();
-            }
-        }
-        return true;
+        // Remove it from the queue history
+        queue_head = (queue_head + 1) % 8;
+        queue_size--;
     }
-    return false;
+    toggle_derived_hash();
+    return true;
 }
 
 /**
- * @brief Checks if the given player has a winning 3-in-a-row on the Infinity board.
+ * @brief Hashes the removal order: the k-th oldest piece on plane 1, rank k,
+ *        at its cell in the board's image under @p transform.
+ */
+unsigned long long X_O_Board::derived_hash(int transform) const {
+    unsigned long long key = 0;
+    for (int k = 0; k < queue_size; ++k)
+        key ^= infinity_keys.cell_key(image_cell(transform, movelist[(queue_head + k) % 8]), k, 1);
+    return key;
+}
+
+/**
+ * @brief Packs the move queue position and its oldest entry for undo.
  *
- * @param player Pointer to the player to check for a win.
- * @return @c true if the player has won, otherwise @c false.
+ * Later moves may overwrite the slot of the oldest entry once it has been
+ * removed, so the entry itself is saved along with the head and size.
  */
-bool X_O_Board::is_win(Player<char>* player) {
-    const char sym = player->get_symbol();
+unsigned long long X_O_Board::save_derived_state() const {
+    return queue_head | (queue_size << 3) | (movelist[queue_head] << 6);
+}
 
-    auto all_equal = [&](char a, char b, char c) {
-        return a == b && b == c && a != blank_symbol;
-        };
+/**
+ * @brief Restores the move queue saved by save_derived_state().
+ */
+void X_O_Board::restore_derived_state(unsigned long long state) {
+    queue_head = state & 7;
+    queue_size = (state >> 3) & 7;
+    movelist[queue_head] = static_cast<int>(state >> 6) & 15;
+}
 
-    // Check rows and columns
-    for (int i = 0; i < rows; ++i) {
-        if ((all_equal(board[i][0], board[i][1], board[i][2]) && board[i][0] == sym) ||
-            (all_equal(board[0][i], board[1][i], board[2][i]) && board[0][i] == sym))
-            return true;
+/**
+ * @brief Writes the move queue: head and size (3 bits each), then each
+ *        queued cell from oldest to newest (4 bits each).
+ */
+void X_O_Board::save_hidden(BitWriter& out) const {
+    out.put(queue_head, 3);
+    out.put(queue_size, 3);
+    for (int k = 0; k < queue_size; ++k)
+        out.put(movelist[(queue_head + k) % 8], 4);
+}
+
+/**
+ * @brief Reads the move queue written by save_hidden(), packed as head
+ *        and size (3 bits each), then each queued cell (4 bits each).
+ *
+ * The queue must hold the last min(@p moves, 6) moves: distinct cells,
+ * each with the symbol of the side that played it, and no other cell may
+ * hold a piece.
+ */
+bool X_O_Board::read_hidden(BitReader& in, const SnapshotCells<char>& cells, int moves,
+                            unsigned long long& hidden) const {
+    int head = static_cast<int>(in.get(3));
+    int size = static_cast<int>(in.get(3));
+    if (head >= 8 || size > 6 || size != min(moves, 6))
+        return false;
+    hidden = head | size << 3;
+    unsigned queued = 0;
+    for (int k = 0; k < size; ++k) {
+        int cell = static_cast<int>(in.get(4));
+        if (cell >= 9 || (queued >> cell) & 1 ||
+            cells.at(cell) != ((moves - size + k) % 2 ? 'O' : 'X'))
+            return false;
+        queued |= 1u << cell;
+        hidden |= static_cast<unsigned long long>(cell) << (6 + 4 * k);
     }
+    for (int cell = 0; cell < 9; ++cell)
+        if (!((queued >> cell) & 1) && cells.at(cell) != blank_symbol)
+            return false;
+    return in.ok();
+}
 
-    // Check diagonals
-    if ((all_equal(board[0][0], board[1][1], board[2][2]) && board[1][1] == sym) ||
-        (all_equal(board[0][2], board[1][1], board[2][0]) && board[1][1] == sym))
-        return true;
+/**
+ * @brief Sets the move queue packed by read_hidden().
+ */
+void X_O_Board::load_hidden(unsigned long long hidden) {
+    queue_head = hidden & 7;
+    queue_size = (hidden >> 3) & 7;
+    for (int k = 0; k < queue_size; ++k)
+        movelist[(queue_head + k) % 8] = (hidden >> (6 + 4 * k)) & 15;
+}
 
-    return false;
+/**
+ * @brief Number of Infinity positions: every queue of up to six distinct
+ *        cells, oldest first; a full queue with either side to move.
+ *
+ * The symbols follow from the queue, as X and O alternate and X moves
+ * first, and the move count matters only through whose turn it is and
+ * whether the next move removes a piece.
+ */
+long long X_O_Board::position_count() const {
+    long long total = arrangements(9, 6); // full queues with O to move
+    for (int size = 0; size <= 6; ++size)
+        total += arrangements(9, size);
+    return total;
+}
+
+/**
+ * @brief Index of the position: shorter queues first, then full queues
+ *        with X and with O to move; within each block the rank of the
+ *        queue as a sequence of cells; -1 if the queue holds more than
+ *        six moves.
+ */
+long long X_O_Board::position_index() const {
+    if (queue_size > 6)
+        return -1;
+    int cells[6];
+    long long index = 0;
+    for (int k = 0; k < queue_size; ++k) {
+        cells[k] = movelist[(queue_head + k) % 8];
+        index += arrangements(9, k);
+    }
+    if (queue_size == 6 && n_moves % 2)
+        index += arrangements(9, 6);
+    return index + rank_arrangement(cells, queue_size, 9);
+}
+
+/**
+ * @brief Sets up the position numbered @p index by position_index().
+ *
+ * A full queue is given six or seven moves played, by the side to move.
+ */
+bool X_O_Board::set_position(long long index) {
+    if (index < 0 || index >= position_count())
+        return false;
+    int size = 0;
+    while (size < 6 && index >= arrangements(9, size))
+        index -= arrangements(9, size++);
+    int moves = size;
+    if (index >= arrangements(9, 6)) {
+        index -= arrangements(9, 6);
+        moves = 7;
+    }
+    int cells[6];
+    unrank_arrangement(index, size, 9, cells);
+
+    board.fill(blank_symbol);
+    queue_head = 0;
+    queue_size = size;
+    for (int k = 0; k < size; ++k) {
+        movelist[k] = cells[k];
+        board[cells[k] / 3][cells[k] % 3] = (moves - size + k) % 2 ? 'O' : 'X';
+    }
+    load_position(moves);
+    return true;
+}
+
+/**
+ * @brief Lists every legal move of the Infinity board.
+ *
+ * Any empty cell may be played; old pieces are removed automatically.
+ *
+ * @param player Player to move.
+ * @param moves Receives the legal moves.
+ */
+void X_O_Board::generate_moves(Player<char>* player, MoveList<char>& moves) {
+    list_empty_cells(blank_symbol, player->get_symbol(), moves);
+}
+
+/**
+ * @brief Checks if the given player has a winning 3-in-a-row on the Infinity board.
+ *
+ * Only the lines through the last piece placed are examined; removing the
+ * oldest piece can never complete a line.
+ *
+ * @param player Pointer to the player to check for a win.
+ * @return @c true if the player has won, otherwise @c false.
+ */
+bool X_O_Board::is_win(Player<char>* player) {
+    return has_line<Lines>(player->get_symbol());
 }
 
 /**
@@ -207,37 +350,38 @@ Player<char>* XO_UI::create_player(string& name, char symbol, PlayerType type) {
 /**
  * @brief Gets a move from the current player for the 3x3 Infinity X-O game.
  *
- * Human players enter coordinates manually, computer players choose random cells.
+ * Human players enter coordinates manually, computer players' agents choose
+ * a legal move.
  *
  * @param player Pointer to the current player.
- * @return Pointer to the newly allocated move.
+ * @return The move read from the player.
  */
-Move<char>* XO_UI::get_move(Player<char>* player) {
+Move<char> XO_UI::get_move(Player<char>* player) {
     int x, y;
 
     if (player->get_type() == PlayerType::HUMAN) {
         cout << "\nPlease enter your move : ";
         cin >> x >> y;
     }
-    else if (player->get_type() == PlayerType::COMPUTER) {
-        x = rand() % player->get_board_ptr()->get_rows();
-        y = rand() % player->get_board_ptr()->get_columns();
+    else {
+        return computer_move(player);
     }
 
-    return new Move<char>(x, y, player->get_symbol());
+    return Move<char>(x, y, player->get_symbol());
 }
 
 //--------------------------------------- 4X4_X_O_Board Implementation
 
+/// Zobrist keys of 4x4 X-O.
+static const ZobristTable four_by_four_keys(16, 1, 2);
+
 /**
  * @brief Constructs a 4x4 X-O board and initializes starting positions.
  *
  * The first and last rows are pre-filled with alternating 'X' and 'O' pieces.
  */
-X_O_Board4::X_O_Board4() : Board(4, 4) {
-    for (auto& row : board)
-        for (auto& cell : row)
-            cell = blank_symbol;
+X_O_Board4::X_O_Board4() {
+    board.fill(blank_symbol);
     for (int i = 0; i < 4; i++) {
         if (i % 2 == 0) {
             board[0][i] = 'O';
@@ -248,27 +392,25 @@ X_O_Board4::X_O_Board4() : Board(4, 4) {
             board[3][i] = 'O';
         }
     }
+    init_hash(four_by_four_keys);
 }
 
 /**
  * @brief Updates the 4x4 sliding X-O board with a directional move.
  *
- * The move is expected to be a @c DirectedMove with a direction:
+ * The move is expected to carry a direction (see @c DirectedMove):
  * - 'L' (left), 'R' (right), 'U' (up), or 'D' (down).
  * The source cell must contain the player's mark, and the destination must be empty.
  *
- * @param move Pointer to a @c DirectedMove describing the move.
+ * @param move Move carrying the source cell and direction.
  * @return @c true if the move is valid and applied, otherwise @c false.
  */
-bool X_O_Board4::update_board(Move<char>* move)
+bool X_O_Board4::update_board(const Move<char>& move)
 {
-    DirectedMove* dm = static_cast<DirectedMove*>(move);
-    if (!dm) return false;
-
-    int x = dm->get_x();
-    int y = dm->get_y();
-    char d = dm->get_direction();
-    char mark = dm->get_symbol();
+    int x = move.get_x();
+    int y = move.get_y();
+    char d = move.get_direction();
+    char mark = move.get_symbol();
 
     // Validate source
     if (x < 0 || x >= 4 || y < 0 || y >= 4)
@@ -296,50 +438,92 @@ bool X_O_Board4::update_board(Move<char>* move)
         return false;
 
     // Apply move
-    board[nx][ny] = mark;
-    board[x][y] = blank_symbol;
+    set_cell(nx, ny, mark);
+    set_cell(x, y, blank_symbol);
+    set_last_move(nx, ny);
+    n_moves++;
+
+    return true;
+}
+
+/**
+ * @brief Number of 4x4 positions: the four X and four O pieces on any of
+ *        the 16 cells, with either side to move.
+ */
+long long X_O_Board4::position_count() const {
+    return 2 * binomial(16, 4) * binomial(12, 4);
+}
+
+/**
+ * @brief Index of the position: the rank of the placement of the pieces,
+ *        after all positions with X to move if O is to move.
+ */
+long long X_O_Board4::position_index() const {
+    unsigned char owner[16];
+    for (int i = 0; i < 16; ++i)
+        owner[i] = board[i / 4][i % 4] == 'X' ? 1 : board[i / 4][i % 4] == 'O' ? 2 : 0;
+    long long rank = rank_placement(owner, 16, 4, 4);
+    if (rank < 0)
+        return -1;
+    return (n_moves % 2) * binomial(16, 4) * binomial(12, 4) + rank;
+}
 
+/**
+ * @brief Sets up the position numbered @p index by position_index().
+ */
+bool X_O_Board4::set_position(long long index) {
+    if (index < 0 || index >= position_count())
+        return false;
+    long long placements = binomial(16, 4) * binomial(12, 4);
+    unsigned char owner[16];
+    unrank_placement(index % placements, 16, 4, 4, owner);
+    for (int i = 0; i < 16; ++i)
+        board[i / 4][i % 4] = owner[i] == 1 ? 'X' : owner[i] == 2 ? 'O' : blank_symbol;
+    load_position(static_cast<int>(index / placements));
     return true;
 }
 
+/**
+ * @brief Lists every legal slide on the 4x4 board.
+ *
+ * Each of the player's pieces may move one step left, right, up or down
+ * into an empty cell.
+ *
+ * @param player Player to move.
+ * @param moves Receives the legal moves as directed moves.
+ */
+void X_O_Board4::generate_moves(Player<char>* player, MoveList<char>& moves) {
+    static const char dirs[4] = { 'L', 'R', 'U', 'D' };
+    static const int dx[4] = { 0, 0, -1, 1 };
+    static const int dy[4] = { -1, 1, 0, 0 };
+    const char mark = player->get_symbol();
+
+    moves.clear();
+    for (int x = 0; x < 4; ++x) {
+        for (int y = 0; y < 4; ++y) {
+            if (board[x][y] != mark) continue;
+            for (int d = 0; d < 4; ++d) {
+                int nx = x + dx[d];
+                int ny = y + dy[d];
+                if (nx >= 0 && nx < 4 && ny >= 0 && ny < 4 && board[nx][ny] == blank_symbol)
+                    moves.add(DirectedMove(x, y, mark, dirs[d]));
+            }
+        }
+    }
+}
+
 /**
  * @brief Checks if the given player has a winning 3-in-a-row on the 4x4 board.
  *
- * All horizontal, vertical and diagonal triplets are considered.
+ * Horizontal, vertical and diagonal triplets through the destination of
+ * the last slide are considered; the vacated source cell cannot complete
+ * a line.
  *
  * @param player Pointer to the player to check.
  * @return @c true if the player has a winning line, otherwise @c false.
  */
 bool X_O_Board4::is_win(Player<char>* player) {
-    const char sym = player->get_symbol();
-
-    auto all_equal = [&](char a, char b, char c) {
-        return a == b && b == c && a != blank_symbol;
-        };
-
-    // Check rows and columns
-    for (int i = 0; i < rows; ++i) {
-        if ((all_equal(board[i][0], board[i][1], board[i][2]) && board[i][0] == sym) ||
-            (all_equal(board[0][i], board[1][i], board[2][i]) && board[0][i] == sym) ||
-            (all_equal(board[i][1], board[i][2], board[i][3]) && board[i][1] == sym) ||
-            (all_equal(board[1][i], board[2][i], board[3][i]) && board[1][i] == sym))
-            return true;
-    }
-
-    // Check diagonals
-    if ((all_equal(board[0][0], board[1][1], board[2][2]) && board[1][1] == sym) ||
-        (all_equal(board[0][2], board[1][1], board[2][0]) && board[1][1] == sym) ||
-        (all_equal(board[3][3], board[1][1], board[2][2]) && board[1][1] == sym) ||
-        (all_equal(board[3][1], board[2][2], board[1][3]) && board[2][2] == sym) ||
-        (all_equal(board[0][1], board[1][2], board[2][3]) && board[1][2] == sym) ||
-        (all_equal(board[1][0], board[2][1], board[3][2]) && board[2][1] == sym) ||
-        (all_equal(board[0][3], board[1][2], board[2][1]) && board[1][2] == sym) ||
-        (all_equal(board[3][0], board[2][1], board[1][2]) && board[3][0] == sym)
-        )
-
-        return true;
-
-    return false;
+    return has_line<Lines>(player->get_symbol());
 }
 
 /**
@@ -369,9 +553,9 @@ Player<char>* XO_UI4::create_player(string& name, char symbol, PlayerType type)
  * where direction is one of L, R, U, D.
  *
  * @param player Pointer to the current player.
- * @return Pointer to a newly allocated @c DirectedMove.
+ * @return A @c DirectedMove carrying the chosen direction.
  */
-Move<char>* XO_UI4::get_move(Player<char>* player) {
+Move<char> XO_UI4::get_move(Player<char>* player) {
     int x, y;
     char direction;
 
@@ -382,14 +566,11 @@ Move<char>* XO_UI4::get_move(Player<char>* player) {
 
     }
     else {
-        // computer random move
-        x = rand() % player->get_board_ptr()->get_rows();
-        y = rand() % player->get_board_ptr()->get_columns();
-        char dirs[4] = { 'L','R','U','D' };
-        direction = dirs[rand() % 4];
+        // computer: the player's agent picks a legal slide
+        return computer_move(player);
     }
 
-    return new DirectedMove(x, y, player->get_symbol(), direction);
+    return DirectedMove(x, y, player->get_symbol(), direction);
 }
 
 /**
@@ -416,18 +597,19 @@ bool X_O_Board4::game_is_over(Player<char>* player) {
 
 //--------------------------------------- Num_X_O_Board Implementation
 
+/// Zobrist keys of Numerical X-O.
+static const ZobristTable numerical_keys(9, 1, 3);
+
 /**
  * @brief Constructs a 3x3 Numerical X-O board.
  *
  * Initializes all cells to blank and marks all digits 1–9 as unused.
  */
-X_O_Num_Board::X_O_Num_Board() : Board(3, 3) {
-    for (auto& row : board)
-        for (auto& cell : row)
-            cell = blank_symbol;
-    for (char i = '1'; i <= '9'; i++) {
-        used_numbers[i] = false;
-    }
+X_O_Num_Board::X_O_Num_Board() {
+    board.fill(blank_symbol);
+    used_numbers = 0;
+    init_hash(numerical_keys);
+    init_symmetry(SquareSymmetry::of<3>());
 }
 
 /**
@@ -437,43 +619,188 @@ X_O_Num_Board::X_O_Num_Board() : Board(3, 3) {
  * - O player plays on odd turns and must place even numbers.
  * - Each number from '1' to '9' can be used at most once.
  *
- * @param move Pointer to the move including coordinates and digit.
+ * @param move The move including coordinates and digit.
  * @return @c true if the move is valid and applied, @c false otherwise.
  */
-bool X_O_Num_Board::update_board(Move<char>* move) {
-    int x = move->get_x();
-    int y = move->get_y();
-    char mark = move->get_symbol();
+bool X_O_Num_Board::update_board(const Move<char>& move) {
+    int x = move.get_x();
+    int y = move.get_y();
+    char mark = move.get_symbol();
+    int digit = mark - '0';
 
     // 1. Validate move logic
-    if (!(x < 0 || x >= rows || y < 0 || y >= columns) &&
-        (board[x][y] == blank_symbol || mark == 0)) {
+    if (x < 0 || x >= rows || y < 0 || y >= columns || board[x][y] != blank_symbol)
+        return false;
+    if (digit < 1 || digit > 9 || (used_numbers >> digit) & 1)
+        return false; // Not a digit, or already used
+
+    if (n_moves % 2 == 0) // X player
+    {
+        // Check if the number is odd
+        if (digit % 2 == 0)
+            return false; // Invalid move
+    }
+    else // O player
+    {
+        // Check if the number is even
+        if (digit % 2 != 0)
+            return false; // Invalid move
+    }
+    used_numbers |= 1 << digit;
+    // 2. Apply the new move
+    set_cell(x, y, mark);
+    n_moves++;
+    return true;
+}
 
-        if (mark == 0) { // Undo move (optional, rarely used in this game type)
-            n_moves--;
-            board[x][y] = blank_symbol;
-        }
-        else {
-            if (n_moves % 2 == 0) // X player
-            {
-                // Check if the number is odd
-                if ((mark - '0') % 2 == 0 || used_numbers[mark - '0'])
-                    return false; // Invalid move
-            }
-            else // O player
-            {
-                // Check if the number is even
-                if ((mark - '0') % 2 != 0 || used_numbers[mark - '0'])
-                    return false; // Invalid move
-            }
-            used_numbers[mark - '0'] = true;
-            // 2. Apply the new move
-            board[x][y] = (mark);
-            n_moves++;
+/**
+ * @brief Packs the used-digit mask for undo.
+ */
+unsigned long long X_O_Num_Board::save_derived_state() const {
+    return used_numbers;
+}
+
+/**
+ * @brief Restores the used-digit mask saved by save_derived_state().
+ */
+void X_O_Num_Board::restore_derived_state(unsigned long long state) {
+    used_numbers = static_cast<unsigned short>(state);
+}
+
+/**
+ * @brief Writes the used-digit mask (10 bits).
+ */
+void X_O_Num_Board::save_hidden(BitWriter& out) const {
+    out.put(used_numbers, 10);
+}
+
+/**
+ * @brief Reads the used-digit mask written by save_hidden().
+ *
+ * The mask must name exactly the digits on the board, each used once,
+ * with as many odd digits as X has played and even ones as O has.
+ */
+bool X_O_Num_Board::read_hidden(BitReader& in, const SnapshotCells<char>& cells, int moves,
+                                unsigned long long& hidden) const {
+    hidden = in.get(10);
+    unsigned long long on_board = 0;
+    int odd = 0, even = 0;
+    for (int i = 0; i < 9; ++i) {
+        int digit = cells.at(i) - '0';
+        if (digit == 0) continue;
+        if ((on_board >> digit) & 1) return false;
+        on_board |= 1ULL << digit;
+        ++(digit % 2 ? odd : even);
+    }
+    return in.ok() && hidden == on_board && odd == (moves + 1) / 2 && even == moves / 2;
+}
+
+/**
+ * @brief Sets the used-digit mask read by read_hidden().
+ */
+void X_O_Num_Board::load_hidden(unsigned long long hidden) {
+    used_numbers = static_cast<unsigned short>(hidden);
+}
+
+/**
+ * @brief Number of Numerical positions with @p n digits down: which
+ *        (n + 1) / 2 of the five odd and n / 2 of the four even digits,
+ *        and the cells they are on.
+ */
+static long long numerical_positions(int n) {
+    return binomial(5, (n + 1) / 2) * binomial(4, n / 2) * arrangements(9, n);
+}
+
+/**
+ * @brief Number of Numerical positions: every way to place the digits
+ *        of the first n moves, for n from 0 to 9.
+ */
+long long X_O_Num_Board::position_count() const {
+    long long total = 0;
+    for (int n = 0; n <= 9; ++n)
+        total += numerical_positions(n);
+    return total;
+}
+
+/**
+ * @brief Index of the position: fewer digits first; then the ranks of the
+ *        sets of odd and of even digits used, and the rank of their cells
+ *        as a sequence, odd digits first, each in increasing order.
+ */
+long long X_O_Num_Board::position_index() const {
+    static const int order[9] = { 1, 3, 5, 7, 9, 2, 4, 6, 8 };
+    int cell_of[10];
+    fill(cell_of, cell_of + 10, -1);
+    for (int i = 0; i < 9; ++i)
+        if (board[i / 3][i % 3] != blank_symbol)
+            cell_of[board[i / 3][i % 3] - '0'] = i;
+
+    int odd[5], even[4], cells[9], a = 0, b = 0, n = 0;
+    for (int digit : order) {
+        if (cell_of[digit] < 0) continue;
+        if (digit % 2) odd[a++] = digit / 2;
+        else even[b++] = digit / 2 - 1;
+        cells[n++] = cell_of[digit];
+    }
+    if (a != (n + 1) / 2)
+        return -1;
+
+    long long index = 0;
+    for (int m = 0; m < n; ++m)
+        index += numerical_positions(m);
+    long long digits = rank_subset(odd, a) * binomial(4, b) + rank_subset(even, b);
+    return index + digits * arrangements(9, n) + rank_arrangement(cells, n, 9);
+}
+
+/**
+ * @brief Sets up the position numbered @p index by position_index(),
+ *        marking its digits used.
+ */
+bool X_O_Num_Board::set_position(long long index) {
+    if (index < 0 || index >= position_count())
+        return false;
+    int n = 0;
+    while (index >= numerical_positions(n))
+        index -= numerical_positions(n++);
+    int a = (n + 1) / 2, b = n / 2;
+    long long digits = index / arrangements(9, n);
+    int odd[5], even[4], cells[9];
+    unrank_subset(digits / binomial(4, b), 5, a, odd);
+    unrank_subset(digits % binomial(4, b), 4, b, even);
+    unrank_arrangement(index % arrangements(9, n), n, 9, cells);
+
+    board.fill(blank_symbol);
+    used_numbers = 0;
+    for (int k = 0; k < n; ++k) {
+        int digit = k < a ? 2 * odd[k] + 1 : 2 * even[k - a] + 2;
+        board[cells[k] / 3][cells[k] % 3] = static_cast<char>('0' + digit);
+        used_numbers |= 1 << digit;
+    }
+    load_position(n);
+    return true;
+}
+
+/**
+ * @brief Lists every legal move of the Numerical board.
+ *
+ * X (even move count) places unused odd digits, O places unused even
+ * digits, on any empty cell.
+ *
+ * @param player Player to move (the digit parity comes from @c n_moves).
+ * @param moves Receives the legal moves; the symbol of each is the digit.
+ */
+void X_O_Num_Board::generate_moves(Player<char>* player, MoveList<char>& moves) {
+    const int first = (n_moves % 2 == 0) ? 1 : 2;
+
+    moves.clear();
+    for (int x = 0; x < rows; ++x) {
+        for (int y = 0; y < columns; ++y) {
+            if (board[x][y] != blank_symbol) continue;
+            for (int digit = first; digit <= 9; digit += 2)
+                if (!((used_numbers >> digit) & 1))
+                    moves.add(Move<char>(x, y, '0' + digit));
         }
-        return true;
     }
-    return false;
 }
 
 /**
@@ -510,26 +837,23 @@ bool X_O_Num_Board::is_win(Player<char>* player) {
 /**
  * @brief Gets a move for the Numerical X-O UI.
  *
- * Human players input (row, column, number). Computer players choose a random
- * cell and a random digit from '1' to '9'.
+ * Human players input (row, column, number). Computer players' agents choose a
+ * legal move, i.e. an unused digit of their parity on an empty cell.
  *
  * @param player Pointer to the current player.
- * @return Pointer to the newly allocated move.
+ * @return The move read from the player.
  */
-Move<char>* XO_Num_UI::get_move(Player<char>* player) {
+Move<char> XO_Num_UI::get_move(Player<char>* player) {
     int x, y;
     char mark;
     if (player->get_type() == PlayerType::HUMAN) {
         cout << "\nPlease enter your move (row column number): ";
         cin >> x >> y >> mark;
     }
-    else if (player->get_type() == PlayerType::COMPUTER) {
-        x = rand() % player->get_board_ptr()->get_rows();
-        y = rand() % player->get_board_ptr()->get_columns();
-        mark = (rand() % 9) + '1'; // Random number between '1' and '9'
-
+    else {
+        return computer_move(player);
     }
-    return new Move<char>(x, y, mark);
+    return Move<char>(x, y, mark);
 }
 
 /**
@@ -614,90 +938,156 @@ int SUS_Board::check(pair<int, int> a, pair<int, int> b, pair<int, int> c) {
 }
 
 /**
- * @brief Global array marking whether a particular SUS line has been counted.
- *
- * Each index 1–8 corresponds to a specific row, column, or diagonal.
+ * @brief Cells of the 8 SUS lines, in the order numbered by SUS_Board::check.
  */
-bool taken[9]{};
+static const int sus_lines[8][3][2] = {
+    { {0, 0}, {0, 1}, {0, 2} }, { {1, 0}, {1, 1}, {1, 2} }, { {2, 0}, {2, 1}, {2, 2} },
+    { {0, 0}, {1, 0}, {2, 0} }, { {0, 1}, {1, 1}, {2, 1} }, { {0, 2}, {1, 2}, {2, 2} },
+    { {0, 0}, {1, 1}, {2, 2} }, { {0, 2}, {1, 1}, {2, 0} }
+};
+
+/// Zobrist keys of SUS.
+static const ZobristTable sus_keys(9, 1, 4);
 
 /**
  * @brief Constructs a 3x3 SUS board initialized with blanks.
  */
-SUS_Board::SUS_Board() : Board(3, 3) {
-    for (auto& row : board)
-        for (auto& cell : row)
-            cell = blank_symbol;
+SUS_Board::SUS_Board() {
+    board.fill(blank_symbol);
+    init_hash(sus_keys);
 }
 
 /**
  * @brief Updates the SUS board with a new move.
  *
  * Standard bounds and occupancy checks are applied. The symbol is converted
- * to upper case when placed.
+ * to upper case when placed, and every SUS line completed by the move is
+ * credited to the player who made it.
  *
- * @param move Pointer to the move.
+ * @param move The move.
  * @return @c true if the move is valid and applied, otherwise @c false.
  */
-bool SUS_Board::update_board(Move<char>* move) {
-    int x = move->get_x();
-    int y = move->get_y();
-    char mark = move->get_symbol();
+bool SUS_Board::update_board(const Move<char>& move) {
+    int x = move.get_x();
+    int y = move.get_y();
+    char mark = move.get_symbol();
 
     // 1. Validate move logic
-    if (!(x < 0 || x >= rows || y < 0 || y >= columns) &&
-        (board[x][y] == blank_symbol || mark == 0)) {
+    if (x < 0 || x >= rows || y < 0 || y >= columns || board[x][y] != blank_symbol)
+        return false;
 
-        if (mark == 0) { // Undo move (optional, rarely used in this game type)
-            n_moves--;
-            board[x][y] = blank_symbol;
+    // 2. Apply the new move
+    n_moves++;
+    set_cell(x, y, toupper(mark));
+
+    // 3. Credit every newly completed SUS line to the player who just moved
+    for (int line = 0; line < 8; ++line) {
+        const int (*cell)[2] = sus_lines[line];
+        if (!((claimed >> line) & 1) &&
+            board[cell[0][0]][cell[0][1]] == 'S' &&
+            board[cell[1][0]][cell[1][1]] == 'U' &&
+            board[cell[2][0]][cell[2][1]] == 'S') {
+            claimed |= 1 << line;
+            int& count = sus_count[n_moves % 2];
+            toggle_hash(sus_keys.extra_key(16 * (n_moves % 2) + count) ^
+                        sus_keys.extra_key(16 * (n_moves % 2) + count + 1));
+            count++;
         }
-        else {
-            // 2. Apply the new move
-            n_moves++;
-            board[x][y] = toupper(mark);
+    }
 
-        }
+    return true;
+}
 
-        return true;
+/**
+ * @brief Hashes the SUS count of each player.
+ *
+ * The claimed lines can be read off the cells, but not who scored them.
+ */
+unsigned long long SUS_Board::derived_hash(int) const {
+    return sus_keys.extra_key(sus_count[0]) ^ sus_keys.extra_key(16 + sus_count[1]);
+}
+
+/**
+ * @brief Packs both SUS counts and the claimed-line mask for undo.
+ */
+unsigned long long SUS_Board::save_derived_state() const {
+    return sus_count[0] | (sus_count[1] << 4) | (claimed << 8);
+}
+
+/**
+ * @brief Restores the SUS counts saved by save_derived_state().
+ */
+void SUS_Board::restore_derived_state(unsigned long long state) {
+    sus_count[0] = state & 15;
+    sus_count[1] = (state >> 4) & 15;
+    claimed = static_cast<unsigned char>(state >> 8);
+}
+
+/**
+ * @brief Writes the SUS counts (4 bits each) and the claimed-line mask.
+ */
+void SUS_Board::save_hidden(BitWriter& out) const {
+    out.put(sus_count[0], 4);
+    out.put(sus_count[1], 4);
+    out.put(claimed, 8);
+}
+
+/**
+ * @brief Reads the SUS state written by save_hidden(), packed as by
+ *        save_derived_state().
+ *
+ * The claimed lines must be exactly those that spell SUS on the board,
+ * and the two counts must add up to their number.
+ */
+bool SUS_Board::read_hidden(BitReader& in, const SnapshotCells<char>& cells, int,
+                            unsigned long long& hidden) const {
+    unsigned long long first = in.get(4);
+    unsigned long long second = in.get(4);
+    unsigned long long lines = in.get(8);
+    hidden = first | second << 4 | lines << 8;
+
+    unsigned long long spelled = 0;
+    int count = 0;
+    for (int line = 0; line < 8; ++line) {
+        const int (*cell)[2] = sus_lines[line];
+        if (cells.at(cell[0][0], cell[0][1]) == 'S' && cells.at(cell[1][0], cell[1][1]) == 'U' &&
+            cells.at(cell[2][0], cell[2][1]) == 'S') {
+            spelled |= 1ULL << line;
+            ++count;
+        }
     }
-    return false;
+    return in.ok() && lines == spelled && first + second == static_cast<unsigned long long>(count);
+}
+
+/**
+ * @brief Sets the SUS state read by read_hidden().
+ */
+void SUS_Board::load_hidden(unsigned long long hidden) {
+    restore_derived_state(hidden);
+}
+
+/**
+ * @brief Lists the player's letter on every empty SUS cell.
+ *
+ * @param player Player to move.
+ * @param moves Receives the legal moves.
+ */
+void SUS_Board::generate_moves(Player<char>* player, MoveList<char>& moves) {
+    list_empty_cells(blank_symbol, player->get_symbol(), moves);
 }
 
 /**
  * @brief Checks if player U (second player) wins the SUS game.
  *
  * The game forms the word "SUS" on rows, columns, or diagonals.
- * The @c sus_count array is used to record the number of SUS lines
- * for each player, but the final winner is only decided at 9 moves.
+ * update_board() records in @c sus_count the number of SUS lines each
+ * player completed, but the final winner is only decided at 9 moves.
  *
  * @param player Pointer to the player (used indirectly via @c n_moves).
  * @return @c true if player U has more SUS lines at the end, otherwise @c false.
  */
 bool SUS_Board::is_win(Player<char>* player) {
-    for (int i = 0; i < 3; ++i) {
-        if (board[0][i] == 'S' && board[1][i] == 'U' && board[2][i] == 'S' && !taken[check({ 0,i }, { 1,i }, { 2,i })]) {
-            sus_count[n_moves % 2]++;
-            taken[check({ 0,i }, { 1,i }, { 2,i })] = 1;
-        }
-        if (board[i][0] == 'S' && board[i][1] == 'U' && board[i][2] == 'S' && !taken[check({ i,0 }, { i,1 }, { i,2 })]) {
-            sus_count[n_moves % 2]++;
-            taken[check({ i,0 }, { i,1 }, { i,2 })] = 1;
-        }
-    }
-    if (board[0][0] == 'S' && board[1][1] == 'U' && board[2][2] == 'S' && !taken[check({ 0,0 }, { 1,1 }, { 2,2 })]) {
-        sus_count[n_moves % 2]++;
-        taken[check({ 0,0 }, { 1,1 }, { 2,2 })] = 1;
-    }
-    if (board[0][2] == 'S' && board[1][1] == 'U' && board[2][0] == 'S' && !taken[check({ 0,2 }, { 1,1 }, { 2,0 })]) {
-        sus_count[n_moves % 2]++;
-        taken[check({ 0,2 }, { 1,1 }, { 2,0 })] = 1;
-    }
-    if (n_moves == 9 && sus_count[1] > sus_count[0]) {
-        return true;
-    }
-    cout << sus_count[1] << "      " << sus_count[0] << '\n';
-
-    return false;
+    return n_moves == 9 && sus_count[1] > sus_count[0];
 }
 
 /**
@@ -769,20 +1159,19 @@ Player<char>* SUS_UI::create_player(string& name, char symbol, PlayerType type)
  * @brief Gets a move from the current player in SUS UI.
  *
  * @param player Pointer to the player.
- * @return Pointer to the new move.
+ * @return The move read from the player.
  */
-Move<char>* SUS_UI::get_move(Player<char>* player) {
+Move<char> SUS_UI::get_move(Player<char>* player) {
     int x, y;
 
     if (player->get_type() == PlayerType::HUMAN) {
         cout << "\nPlease enter your move x and y (0 to 2): ";
         cin >> x >> y;
     }
-    else if (player->get_type() == PlayerType::COMPUTER) {
-        x = rand() % player->get_board_ptr()->get_rows();
-        y = rand() % player->get_board_ptr()->get_columns();
+    else {
+        return computer_move(player);
     }
-    return new Move<char>(x, y, player->get_symbol());
+    return Move<char>(x, y, player->get_symbol());
 }
 
 /**
@@ -792,7 +1181,7 @@ Move<char>* SUS_UI::get_move(Player<char>* player) {
  */
 Player<char>** SUS_UI::setup_players() {
     Player<char>** players = new Player<char>*[2];
-    vector<string> type_options = { "Human", "Computer" };
+    vector<string> type_options = player_type_options();
 
     string nameS = get_player_name("Player S");
     PlayerType typeS = get_player_type_choice("Player S", type_options);
@@ -802,52 +1191,58 @@ Player<char>** SUS_UI::setup_players() {
     PlayerType typeU = get_player_type_choice("Player U", type_options);
     players[1] = create_player(nameU, static_cast<char>('U'), typeU);
 
+    players[0]->set_agent(create_agent(typeS, players[1]));
+    players[1]->set_agent(create_agent(typeU, players[0]));
     return players;
 }
 
 //--------------------------------------Inverse_X_O_Board Implementation
 
+/// Zobrist keys of Misere X-O.
+static const ZobristTable inverse_keys(9, 1, 5);
+
 /**
  * @brief Constructs an inverse 3x3 X-O board initialized to blanks.
  *
  * Inverse X-O is a variant where forming a 3-in-a-row causes a loss.
  */
-X_O_Inverse_Board::X_O_Inverse_Board() : Board(3, 3) {
+X_O_Inverse_Board::X_O_Inverse_Board() {
     // Initialize all cells with blank_symbol
-    for (auto& row : board)
-        for (auto& cell : row)
-            cell = blank_symbol;
+    board.fill(blank_symbol);
+    init_hash(inverse_keys);
+    init_symmetry(SquareSymmetry::of<3>());
 }
 
 /**
  * @brief Updates the inverse X-O board with a move.
  *
  * Standard bounds and occupancy checks are applied and symbols are uppercased.
- * A move with symbol 0 is treated as an undo.
  *
- * @param move Pointer to the move.
+ * @param move The move.
  * @return @c true if move is valid and applied, otherwise @c false.
  */
-bool X_O_Inverse_Board::update_board(Move<char>* move) {
-    int x = move->get_x();
-    int y = move->get_y();
-    char mark = move->get_symbol();
+bool X_O_Inverse_Board::update_board(const Move<char>& move) {
+    int x = move.get_x();
+    int y = move.get_y();
+    char mark = move.get_symbol();
 
     // Validate move and apply if valid
-    if (!(x < 0 || x >= rows || y < 0 || y >= columns) &&
-        (board[x][y] == blank_symbol || mark == 0)) {
+    if (x < 0 || x >= rows || y < 0 || y >= columns || board[x][y] != blank_symbol)
+        return false;
 
-        if (mark == 0) { // Undo move
-            n_moves--;
-            board[x][y] = blank_symbol;
-        }
-        else {         // Apply move
-            n_moves++;
-            board[x][y] = toupper(mark);
-        }
-        return true;
-    }
-    return false;
+    n_moves++;
+    set_cell(x, y, toupper(mark));
+    return true;
+}
+
+/**
+ * @brief Lists a placement on every empty cell of the inverse board.
+ *
+ * @param player Pointer to the player.
+ * @param moves Receives the legal moves.
+ */
+void X_O_Inverse_Board::generate_moves(Player<char>* player, MoveList<char>& moves) {
+    list_empty_cells(blank_symbol, player->get_symbol(), moves);
 }
 
 /**
@@ -929,36 +1324,37 @@ Player<char>* XO_Inverse_UI::create_player(string& name, char symbol, PlayerType
  * @brief Gets a move from the current player in inverse X-O UI.
  *
  * @param player Pointer to the player.
- * @return Pointer to the new move.
+ * @return The move read from the player.
  */
-Move<char>* XO_Inverse_UI::get_move(Player<char>* player) {
+Move<char> XO_Inverse_UI::get_move(Player<char>* player) {
     int x, y;
 
     if (player->get_type() == PlayerType::HUMAN) {
         cout << "\nPlease enter your move x and y (0 to 2): ";
         cin >> x >> y;
     }
-    else if (player->get_type() == PlayerType::COMPUTER) {
-        x = rand() % player->get_board_ptr()->get_rows();
-        y = rand() % player->get_board_ptr()->get_columns();
+    else {
+        return computer_move(player);
     }
-    return new Move<char>(x, y, player->get_symbol());
+    return Move<char>(x, y, player->get_symbol());
 }
 
 //--------------------------------------- Pyramid_X_O_Board Implementation
 
+/// Zobrist keys of Pyramid X-O.
+static const ZobristTable pyramid_keys(15, 1, 6);
+
 /**
  * @brief Constructs a Pyramid X-O board (3x5) and initializes the pyramid shape.
  *
  * Invalid cells are represented with '*' on the internal board.
  */
-Pyramid_X_O_Board::Pyramid_X_O_Board() : Board(3, 5) {
+Pyramid_X_O_Board::Pyramid_X_O_Board() {
     // Initialize all cells with blank_symbol
-    for (auto& row : board)
-        for (auto& cell : row)
-            cell = blank_symbol;
+    board.fill(blank_symbol);
     board[0][0] = '*'; board[0][1] = '*'; board[0][3] = '*'; board[0][4] = '*';
     board[1][0] = '*'; board[1][4] = '*';
+    init_hash(pyramid_keys);
 }
 
 /**
@@ -966,57 +1362,107 @@ Pyramid_X_O_Board::Pyramid_X_O_Board() : Board(3, 5) {
  *
  * Bounds and occupancy are checked; symbol is uppercased.
  *
- * @param move Pointer to the move.
+ * @param move The move.
  * @return @c true if the move is valid and applied, otherwise @c false.
  */
-bool Pyramid_X_O_Board::update_board(Move<char>* move) {
-    int x = move->get_x();
-    int y = move->get_y();
-    char mark = move->get_symbol();
+bool Pyramid_X_O_Board::update_board(const Move<char>& move) {
+    int x = move.get_x();
+    int y = move.get_y();
+    char mark = move.get_symbol();
+
     // Validate move and apply if valid
-    if (!(x < 0 || x >= rows || y < 0 || y >= columns) &&
-        (board[x][y] == blank_symbol || mark == 0
-            )) {
-        if (mark == 0) { // Undo move
-            n_moves--;
-            board[x][y] = blank_symbol;
-        }
-        else {         // Apply move
-            n_moves++;
-            board[x][y] = toupper(mark);
-        }
-        return true;
+    if (x < 0 || x >= rows || y < 0 || y >= columns || board[x][y] != blank_symbol)
+        return false;
+
+    n_moves++;
+    set_cell(x, y, toupper(mark));
+    set_last_move(x, y);
+    return true;
+}
+
+/// The nine cells of the pyramid, row-major.
+static const int pyramid_cells[9] = { 2, 6, 7, 8, 10, 11, 12, 13, 14 };
+
+/**
+ * @brief Number of Pyramid positions with @p n pieces down:
+ *        (n + 1) / 2 X and n / 2 O pieces on the nine cells.
+ */
+static long long pyramid_positions(int n) {
+    return binomial(9, (n + 1) / 2) * binomial(9 - (n + 1) / 2, n / 2);
+}
+
+/**
+ * @brief Number of Pyramid positions: every placement of the pieces of
+ *        the first n moves, for n from 0 to 9.
+ */
+long long Pyramid_X_O_Board::position_count() const {
+    long long total = 0;
+    for (int n = 0; n <= 9; ++n)
+        total += pyramid_positions(n);
+    return total;
+}
+
+/**
+ * @brief Index of the position: fewer pieces first, then the rank of the
+ *        placement of the pieces.
+ */
+long long Pyramid_X_O_Board::position_index() const {
+    unsigned char owner[9];
+    int n = 0;
+    for (int i = 0; i < 9; ++i) {
+        char cell = board[pyramid_cells[i] / 5][pyramid_cells[i] % 5];
+        owner[i] = cell == 'X' ? 1 : cell == 'O' ? 2 : 0;
+        n += owner[i] != 0;
     }
-    return false;
+    long long rank = rank_placement(owner, 9, (n + 1) / 2, n / 2);
+    if (rank < 0)
+        return -1;
+    for (int m = 0; m < n; ++m)
+        rank += pyramid_positions(m);
+    return rank;
+}
+
+/**
+ * @brief Sets up the position numbered @p index by position_index().
+ */
+bool Pyramid_X_O_Board::set_position(long long index) {
+    if (index < 0 || index >= position_count())
+        return false;
+    int n = 0;
+    while (index >= pyramid_positions(n))
+        index -= pyramid_positions(n++);
+    unsigned char owner[9];
+    unrank_placement(index, 9, (n + 1) / 2, n / 2, owner);
+    for (int i = 0; i < 9; ++i)
+        board[pyramid_cells[i] / 5][pyramid_cells[i] % 5] =
+            owner[i] == 1 ? 'X' : owner[i] == 2 ? 'O' : blank_symbol;
+    load_position(n);
+    return true;
+}
+
+/**
+ * @brief Lists a placement on every empty pyramid cell.
+ *
+ * Cells outside the pyramid hold '*' and are never listed.
+ *
+ * @param player Pointer to the player.
+ * @param moves Receives the legal moves.
+ */
+void Pyramid_X_O_Board::generate_moves(Player<char>* player, MoveList<char>& moves) {
+    list_empty_cells(blank_symbol, player->get_symbol(), moves);
 }
 
 /**
  * @brief Checks if the given player has a winning triple in Pyramid X-O.
  *
- * The win patterns follow lines inside the pyramid.
+ * The line table is masked to the pyramid's cells, so only its seven
+ * lines exist; those through the last move are checked.
  *
  * @param player Pointer to the player.
  * @return @c true if player has a winning line, otherwise @c false.
  */
 bool Pyramid_X_O_Board::is_win(Player<char>* player) {
-    const char sym = player->get_symbol();
-    auto all_equal = [&](char a, char b, char c) {
-        return a == b && b == c && a != blank_symbol;
-        };
-    // Check pyramid rows
-    if (all_equal(board[0][2], board[1][1], board[2][0]) && board[2][0] == sym)
-        return true;
-    if (all_equal(board[1][1], board[1][2], board[1][3]) && board[1][3] == sym)
-        return true;
-    if (all_equal(board[1][3], board[0][2], board[2][4]) && board[1][3] == sym)
-        return true;
-    if (all_equal(board[0][2], board[1][2], board[2][2]) && board[2][2] == sym)
-        return true;
-    for (int i = 0; i < 3; ++i) {
-        if ((all_equal(board[2][i], board[2][i + 1], board[2][i + 2]) && board[2][i] == sym))
-            return true;
-    }
-    return false;
+    return has_line<Lines>(player->get_symbol());
 }
 
 /**
@@ -1073,31 +1519,32 @@ Player<char>* Pyramid_XO_UI::create_player(string& name, char symbol, PlayerType
  * @brief Gets a move from the player for Pyramid X-O.
  *
  * @param player Pointer to the player.
- * @return Pointer to the new move.
+ * @return The move read from the player.
  */
-Move<char>* Pyramid_XO_UI::get_move(Player<char>* player) {
+Move<char> Pyramid_XO_UI::get_move(Player<char>* player) {
     int x, y;
     if (player->get_type() == PlayerType::HUMAN) {
         cout << "\nEnter your move for Pyramid X-O (row col): ";
         cin >> x >> y;
     }
     else {
-        // computer random move
-        x = rand() % player->get_board_ptr()->get_rows();
-        y = rand() % player->get_board_ptr()->get_columns();
+        return computer_move(player);
     }
-    return new Move<char>(x, y, player->get_symbol());
+    return Move<char>(x, y, player->get_symbol());
 }
 
 //--------------------------------------- Word_X_O_Board Implementation
 
+/// Zobrist keys of Word X-O.
+static const ZobristTable word_keys(9, 1, 7);
+
 /**
  * @brief Constructs a 3x3 WORD X-O board with all cells blank.
  */
-X_O_Board_WORD::X_O_Board_WORD() : Board(3, 3) {
-    for (auto& row : board)
-        for (auto& cell : row)
-            cell = blank_symbol;
+X_O_Board_WORD::X_O_Board_WORD() {
+    board.fill(blank_symbol);
+    init_hash(word_keys);
+    init_symmetry(SquareSymmetry::of<3>());
 }
 
 /**
@@ -1118,13 +1565,13 @@ Player<char>* XO_UI_WORD::create_player(string& name, char symbol, PlayerType ty
 /**
  * @brief Gets a move from the player for WORD X-O.
  *
- * Human players input (row, column, letter), and computer players choose random
- * positions and random letters.
+ * Human players input (row, column, letter), and computer players' agents
+ * choose an empty position and a letter.
  *
  * @param player Pointer to the player.
- * @return Pointer to the new move.
+ * @return The move read from the player.
  */
-Move<char>* XO_UI_WORD::get_move(Player<char>* player) {
+Move<char> XO_UI_WORD::get_move(Player<char>* player) {
     int x, y;
     char mark;
 
@@ -1132,53 +1579,59 @@ Move<char>* XO_UI_WORD::get_move(Player<char>* player) {
         cout << "\nPlease enter your move ( row column word ) : ";
         cin >> x >> y >> mark;
     }
-    else if (player->get_type() == PlayerType::COMPUTER) {
-        x = rand() % player->get_board_ptr()->get_rows();
-        y = rand() % player->get_board_ptr()->get_columns();
-        mark = 'A' + rand() % 26;
+    else {
+        return computer_move(player);
     }
 
-    return new Move<char>(x, y, mark);
+    return Move<char>(x, y, mark);
 }
 
 /**
  * @brief Updates the WORD X-O board with a new symbol.
  *
- * @param move Pointer to the move with coordinates and character.
+ * @param move The move with coordinates and character.
  * @return @c true if move is valid and applied, otherwise @c false.
  */
-bool X_O_Board_WORD::update_board(Move<char>* move) {
-    int x = move->get_x();
-    int y = move->get_y();
-    char mark = move->get_symbol();
+bool X_O_Board_WORD::update_board(const Move<char>& move) {
+    int x = move.get_x();
+    int y = move.get_y();
+    char mark = move.get_symbol();
 
-    if (!(x < 0 || x >= rows || y < 0 || y >= columns) &&
-        (board[x][y] == blank_symbol || mark == 0)) {
+    // Validate move and apply if valid
+    if (x < 0 || x >= rows || y < 0 || y >= columns || board[x][y] != blank_symbol)
+        return false;
 
-        if (mark == 0) { // Undo move (optional, rarely used in this game type)
-            n_moves--;
-            board[x][y] = blank_symbol;
-        }
-        else {
-            // 2. Apply the new move
-            n_moves++;
-            board[x][y] = toupper(mark);
-        }
-        return true;
-    }
-    return false;
+    n_moves++;
+    set_cell(x, y, toupper(mark));
+    return true;
+}
+
+/**
+ * @brief Lists every letter A-Z on every empty cell.
+ *
+ * @param player Pointer to player (any player may place any letter).
+ * @param moves Receives the legal moves.
+ */
+void X_O_Board_WORD::generate_moves(Player<char>* player, MoveList<char>& moves) {
+    moves.clear();
+    for (int x = 0; x < rows; ++x)
+        for (int y = 0; y < columns; ++y)
+            if (board[x][y] == blank_symbol)
+                for (char letter = 'A'; letter <= 'Z'; ++letter)
+                    moves.add(Move<char>(x, y, letter));
 }
 
 /**
  * @brief Checks if any row, column, or diagonal forms a valid dictionary word.
  *
  * Both normal and reversed directions are checked against the dictionary
- * set @c s.
+ * returned by dictionary().
  *
  * @param player Pointer to player (unused in logic).
  * @return @c true if any 3-letter line forms a valid word, otherwise @c false.
  */
 bool X_O_Board_WORD::is_win(Player<char>* player) {
+    const unordered_set<string>& words = dictionary();
 
     // Check rows and columns
     for (int i = 0; i < rows; ++i) {
@@ -1190,14 +1643,14 @@ bool X_O_Board_WORD::is_win(Player<char>* player) {
         t.push_back(board[0][i]);
         t.push_back(board[1][i]);
         t.push_back(board[2][i]);
-        if (s.find(e) != s.end() || s.find(t) != s.end()) {
+        if (words.count(e) || words.count(t)) {
             return true;
         }
 
         reverse(e.begin(), e.end());
         reverse(t.begin(), t.end());
 
-        if (s.find(e) != s.end() || s.find(t) != s.end()) {
+        if (words.count(e) || words.count(t)) {
             return true;
         }
         e.clear();
@@ -1213,13 +1666,13 @@ bool X_O_Board_WORD::is_win(Player<char>* player) {
     t.push_back(board[0][2]);
     t.push_back(board[1][1]);
     t.push_back(board[2][0]);
-    if (s.find(e) != s.end() || s.find(t) != s.end()) {
+    if (words.count(e) || words.count(t)) {
         return true;
     }
     reverse(e.begin(), e.end());
     reverse(t.begin(), t.end());
 
-    if (s.find(e) != s.end() || s.find(t) != s.end()) {
+    if (words.count(e) || words.count(t)) {
         return true;
     }
     e.clear();
@@ -1253,112 +1706,14 @@ bool X_O_Board_WORD::game_is_over(Player<char>* player) {
 
 //--------------------------------------- Connect4 Implementation
 
-/**
- * @brief Constructs a 6x7 Connect 4 board initialized to blanks.
- */
-Connect4_Board::Connect4_Board() : Board(6, 7) {
-    // Initialize all cells with blank_symbol
-    for (auto& row : board)
-        for (auto& cell : row)
-            cell = blank_symbol;
-}
-
-/**
- * @brief Updates the Connect 4 board with a new move.
- *
- * A piece must either be on the bottom row or sit on top of another piece.
- *
- * @param move Pointer to the move containing (row, column, symbol).
- * @return @c true if move is valid and applied, otherwise @c false.
- */
-bool Connect4_Board::update_board(Move<char>* move) {
-    int x = move->get_x();
-    int y = move->get_y();
-    char mark = move->get_symbol();
-
-    // Validate move and apply if valid
-    if (!(x < 0 || x >= rows || y < 0 || y >= columns) &&
-        (board[x][y] == blank_symbol || mark == 0) && (x == 5 || (x < 5 && board[x + 1][y] != blank_symbol))) {
-
-        if (mark == 0) { // Undo move
-            n_moves--;
-            board[x][y] = blank_symbol;
-        }
-        else {         // Apply move
-            n_moves++;
-            board[x][y] = toupper(mark);
-        }
-        return true;
-    }
-    return false;
-}
-
-/**
- * @brief Checks if the given player has 4 in a row in Connect 4.
- *
- * All horizontal, vertical, and diagonal lines of length 4 are checked.
- *
- * @param player Pointer to the player.
- * @return @c true if the player has a connect-4, otherwise @c false.
- */
-bool Connect4_Board::is_win(Player<char>* player) {
-    const char sym = player->get_symbol();
-
-    auto all_equal = [&](char a, char b, char c, char d) {
-        return a == b && b == c && c == d && a != blank_symbol;
-        };
-
-    // Check rows and columns
-    for (int i = 0; i < 3; i++) {
-        for (int j = 0; j < 7; j++) {
-            if (all_equal(board[0 + i][j], board[1 + i][j], board[2 + i][j], board[3 + i][j]) && board[i][j] == sym) {
-                return true;//column
-            }
-        }
-    }
-    for (int i = 0; i < 6; i++) {
-        for (int j = 0; j < 4; j++) {
-            if (all_equal(board[i][0 + j], board[i][1 + j], board[i][2 + j], board[i][3 + j]) && board[i][j] == sym) {
-                return true;//row
-            }
-        }
-    }
-
-    // Check diagonals
-    for (int i = 0; i < 3; i++) {
-        for (int j = 0; j < 4; j++) {
-            if (all_equal(board[i][j + 3], board[i + 1][j + 2], board[i + 2][j + 1], board[i + 3][j]) && board[i][j + 3] == sym) {
-                return true;
-            }
-            if (all_equal(board[i][3 - j], board[i][4 - j], board[i][5 - j], board[i][6 - j]) && board[i][3 - j] == sym) {
-                return true;
-            }
-        }
-    }
-
-    return false;
-}
-
-/**
- * @brief Checks if the Connect 4 game is a draw.
- *
- * Draw occurs when the board is full (42 moves) with no winner.
- *
- * @param player Pointer to player.
- * @return @c true if draw, otherwise @c false.
- */
-bool Connect4_Board::is_draw(Player<char>* player) {
-    return (n_moves == 42 && !is_win(player));
-}
+/// Zobrist keys of Connect 4.
+static const ZobristTable connect4_keys(42, 1, 8);
 
 /**
- * @brief Checks whether the Connect 4 game is over.
- *
- * @param player Pointer to player.
- * @return @c true if win or draw, otherwise @c false.
+ * @brief Constructs a 6x7 Connect 4 board initialized to blanks.
  */
-bool Connect4_Board::game_is_over(Player<char>* player) {
-    return is_win(player) || is_draw(player);
+Connect4_Board::Connect4_Board() {
+    init_hash(connect4_keys);
 }
 
 /**
@@ -1386,36 +1741,37 @@ Player<char>* Connect4_UI::create_player(string& name, char symbol, PlayerType t
  * @brief Gets a move from the player for Connect 4.
  *
  * @param player Pointer to the player.
- * @return Pointer to the new move.
+ * @return The move read from the player.
  */
-Move<char>* Connect4_UI::get_move(Player<char>* player) {
+Move<char> Connect4_UI::get_move(Player<char>* player) {
     int x, y;
 
     if (player->get_type() == PlayerType::HUMAN) {
         cout << "\nPlease enter your move x and y (0 to 5) and (0 to 6): ";
         cin >> x >> y;
     }
-    else if (player->get_type() == PlayerType::COMPUTER) {
-        x = rand() % player->get_board_ptr()->get_rows();
-        y = rand() % player->get_board_ptr()->get_columns();
+    else {
+        return computer_move(player);
     }
-    return new Move<char>(x, y, player->get_symbol());
+    return Move<char>(x, y, player->get_symbol());
 }
 
 //--------------------------------------- Memo_XO_Classes.cpp
 
+/// Zobrist keys of Memory X-O (plane 1 hashes the hidden symbols).
+static const ZobristTable memo_keys(9, 2, 9);
+
 /**
  * @brief Constructs a Memory X-O board and initializes the revealed matrix.
  *
  * The public board shows '#' for hidden cells, while @c revealed stores
  * the actual underlying symbols.
  */
-Memo_X_O_Board::Memo_X_O_Board() : Board(3, 3) {
+Memo_X_O_Board::Memo_X_O_Board() : revealed(blank_symbol) {
     // Initialize all cells with blank_symbol
-    for (auto& row : board)
-        for (auto& cell : row)
-            cell = blank_symbol;
-    revealed = vector<vector<char>>(3, vector<char>(3, blank_symbol));
+    board.fill(blank_symbol);
+    init_hash(memo_keys);
+    init_symmetry(SquareSymmetry::of<3>());
 }
 
 /**
@@ -1424,13 +1780,13 @@ Memo_X_O_Board::Memo_X_O_Board() : Board(3, 3) {
  * The symbol is placed in @c revealed, whereas the public board
  * simply shows '#'.
  *
- * @param move Pointer to the move.
+ * @param move The move.
  * @return @c true if the move is valid and applied, otherwise @c false.
  */
-bool Memo_X_O_Board::update_board(Move<char>* move) {
-    int x = move->get_x();
-    int y = move->get_y();
-    char mark = move->get_symbol();
+bool Memo_X_O_Board::update_board(const Move<char>& move) {
+    int x = move.get_x();
+    int y = move.get_y();
+    char mark = move.get_symbol();
 
     // bounds check
     if (x < 0 || x >= rows || y < 0 || y >= columns)
@@ -1442,38 +1798,109 @@ bool Memo_X_O_Board::update_board(Move<char>* move) {
 
     // place REAL symbol
     revealed[x][y] = toupper(mark);
+    toggle_cell_key(memo_keys, x * columns + y, symbol_code(blank_symbol), 1);
+    toggle_cell_key(memo_keys, x * columns + y, symbol_code(revealed[x][y]), 1);
 
     // board stays hidden
-    board[x][y] = '#';
+    set_cell(x, y, '#');
+    set_last_move(x, y);
 
     n_moves++;
     return true;
 }
 
+/**
+ * @brief Clears hidden cells whose public cell was restored by unmake_move().
+ *
+ * A cell is hidden ('#') exactly when the real board holds a symbol, so
+ * the real board can be rebuilt from the restored public board.
+ */
+void Memo_X_O_Board::restore_derived_state(unsigned long long) {
+    for (int x = 0; x < rows; ++x)
+        for (int y = 0; y < columns; ++y)
+            if (board[x][y] == blank_symbol)
+                revealed[x][y] = blank_symbol;
+}
+
+/**
+ * @brief Hashes the hidden symbols on plane 1, at their cells in the
+ *        board's image under @p transform.
+ */
+unsigned long long Memo_X_O_Board::derived_hash(int transform) const {
+    unsigned long long key = 0;
+    for (int x = 0; x < rows; ++x)
+        for (int y = 0; y < columns; ++y)
+            key ^= memo_keys.cell_key(image_cell(transform, x * columns + y), symbol_code(revealed[x][y]), 1);
+    return key;
+}
+
+/**
+ * @brief Writes the hidden symbols, 2 bits per cell ('.', 'X' or 'O').
+ */
+void Memo_X_O_Board::save_hidden(BitWriter& out) const {
+    static const CellAlphabet<char> symbols(".XO", 3);
+    for (int x = 0; x < rows; ++x)
+        for (int y = 0; y < columns; ++y) {
+            int code = symbols.code(revealed[x][y]);
+            if (code < 0) out.fail();
+            out.put(code < 0 ? 0 : code, 2);
+        }
+}
+
+/**
+ * @brief Reads the hidden symbols written by save_hidden(), packed
+ *        2 bits per cell.
+ *
+ * A cell must hold a hidden symbol exactly when the board shows '#', and
+ * X and O must have played @p moves moves between them, X first.
+ */
+bool Memo_X_O_Board::read_hidden(BitReader& in, const SnapshotCells<char>& cells, int moves,
+                                 unsigned long long& hidden) const {
+    hidden = 0;
+    int played[3] = {};
+    for (int i = 0; i < 9; ++i) {
+        unsigned long long code = in.get(2);
+        if (code > 2 || (code != 0) != (cells.at(i) == '#')) return false;
+        hidden |= code << (2 * i);
+        ++played[code];
+    }
+    return in.ok() && played[1] == (moves + 1) / 2 && played[2] == moves / 2;
+}
+
+/**
+ * @brief Sets the hidden symbols read by read_hidden().
+ */
+void Memo_X_O_Board::load_hidden(unsigned long long hidden) {
+    static const char symbols[3] = { '.', 'X', 'O' };
+    for (int i = 0; i < 9; ++i)
+        revealed[i / 3][i % 3] = symbols[(hidden >> (2 * i)) & 3];
+}
+
+/**
+ * @brief Lists every cell that is still empty on the hidden board.
+ *
+ * @param player Pointer to the player.
+ * @param moves Receives the legal moves.
+ */
+void Memo_X_O_Board::generate_moves(Player<char>* player, MoveList<char>& moves) {
+    moves.clear();
+    for (int x = 0; x < rows; ++x)
+        for (int y = 0; y < columns; ++y)
+            if (revealed[x][y] == blank_symbol)
+                moves.add(Move<char>(x, y, player->get_symbol()));
+}
+
 /**
  * @brief Checks whether the given player has a winning 3-in-a-row on the hidden board.
  *
- * The check is done on the @c revealed array, not the public board.
+ * The check is done on the @c revealed grid, not the public board, through
+ * the last move only.
  *
  * @param player Pointer to the player.
  * @return @c true if player has a winning line, otherwise @c false.
  */
 bool Memo_X_O_Board::is_win(Player<char>* player) {
-    const char sym = player->get_symbol();
-    auto all_equal = [&](char a, char b, char c) {
-        return a == b && b == c && a != blank_symbol;
-        };
-    // Check rows and columns
-    for (int i = 0; i < rows; ++i) {
-        if ((all_equal(revealed[i][0], revealed[i][1], revealed[i][2]) && revealed[i][0] == sym) ||
-            (all_equal(revealed[0][i], revealed[1][i], revealed[2][i]) && revealed[0][i] == sym))
-            return true;
-    }
-    // Check diagonals
-    if ((all_equal(revealed[0][0], revealed[1][1], revealed[2][2]) && revealed[1][1] == sym) ||
-        (all_equal(revealed[0][2], revealed[1][1], revealed[2][0]) && revealed[1][1] == sym))
-        return true;
-    return false;
+    return has_line<Lines>(revealed.data(), player->get_symbol());
 }
 
 /**
@@ -1517,29 +1944,31 @@ Player<char>* Memo_XO_UI::create_player(string& name, char symbol, PlayerType ty
  * @brief Gets a move from the player for Memory X-O.
  *
  * @param player Pointer to player.
- * @return Pointer to new move.
+ * @return The move read from the player.
  */
-Move<char>* Memo_XO_UI::get_move(Player<char>* player) {
+Move<char> Memo_XO_UI::get_move(Player<char>* player) {
     int x, y;
     if (player->get_type() == PlayerType::HUMAN) {
         cout << "\nPlease enter your move (row column): ";
         cin >> x >> y;
     }
-    else if (player->get_type() == PlayerType::COMPUTER) {
-        x = rand() % player->get_board_ptr()->get_rows();
-        y = rand() % player->get_board_ptr()->get_columns();
+    else {
+        return computer_move(player);
     }
-    return new Move<char>(x, y, player->get_symbol());
+    return Move<char>(x, y, player->get_symbol());
 }
 
 //--------------------------------------- Diamond_X_O_Board Implementation
 
+/// Zobrist keys of Diamond X-O.
+static const ZobristTable diamond_keys(49, 1, 10);
+
 /**
  * @brief Constructs a 7x7 Diamond X-O board with a diamond-shaped valid region.
  *
  * Valid cells (forming a diamond) are initialized with '.', invalid ones with '$'.
  */
-Diamond_X_O_Board::Diamond_X_O_Board() :Board<char>(7, 7) {
+Diamond_X_O_Board::Diamond_X_O_Board() {
     for (int i = 0; i < 7; ++i) {
         for (int j = 0; j < 7; ++j) {
             bool valid = (abs(i - 3) + abs(j - 3) <= 3);
@@ -1553,6 +1982,8 @@ Diamond_X_O_Board::Diamond_X_O_Board() :Board<char>(7, 7) {
     }
 
     n_moves = 0;
+    init_hash(diamond_keys);
+    init_symmetry(SquareSymmetry::of<7>());
 }
 
 /**
@@ -1560,23 +1991,35 @@ Diamond_X_O_Board::Diamond_X_O_Board() :Board<char>(7, 7) {
  *
  * The move must target a valid diamond cell that is empty.
  *
- * @param move Pointer to the move.
+ * @param move The move.
  * @return @c true if move valid and applied, otherwise @c false.
  */
-bool Diamond_X_O_Board::update_board(Move<char>* move) {
-    int x = move->get_x();
-    int y = move->get_y();
-    char mark = move->get_symbol();
+bool Diamond_X_O_Board::update_board(const Move<char>& move) {
+    int x = move.get_x();
+    int y = move.get_y();
+    char mark = move.get_symbol();
 
     if (x < 0 || x >= 7 || y < 0 || y >= 7) return false;
     if (!valid_cell[x][y]) return false;
     if (board[x][y] != blank_symbol) return false;
 
-    board[x][y] = toupper(mark);
+    set_cell(x, y, toupper(mark));
     ++n_moves;
     return true;
 }
 
+/**
+ * @brief Lists every empty cell inside the diamond.
+ *
+ * Cells outside the diamond hold '$' and are never listed.
+ *
+ * @param player Pointer to the player.
+ * @param moves Receives the legal moves.
+ */
+void Diamond_X_O_Board::generate_moves(Player<char>* player, MoveList<char>& moves) {
+    list_empty_cells(blank_symbol, player->get_symbol(), moves);
+}
+
 /**
  * @brief Collects all lines of a given length formed by the player's symbol.
  *
@@ -1730,29 +2173,37 @@ Player<char>* Diamond_X_O_UI::create_player(string& name, char symbol, PlayerTyp
     return new Player<char>(name, symbol, type);
 }
 
+/**
+ * @brief Creates the agent of a player; AI players use Monte Carlo tree
+ *        search, which copes with the wide diamond better
+ *        than alpha-beta.
+ *
+ * @param type Player type.
+ * @param opponent The other player.
+ * @return The new agent, nullptr for a human.
+ */
+MoveAgent<char>* Diamond_X_O_UI::create_agent(PlayerType type, Player<char>* opponent) {
+    if (type == PlayerType::AI)
+        return new MCTSAgent<char>(opponent, rng);
+    return UI<char>::create_agent(type, opponent);
+}
+
 /**
  * @brief Gets a move from the player for Diamond X-O UI.
  *
  * @param player Pointer to player.
- * @return Pointer to new move.
+ * @return The move read from the player.
  */
-Move<char>* Diamond_X_O_UI::get_move(Player<char>* player) {
+Move<char> Diamond_X_O_UI::get_move(Player<char>* player) {
     int x, y;
     if (player->get_type() == PlayerType::HUMAN) {
         cout << "Enter move (row col 0–6): ";
         cin >> x >> y;
-        return new Move<char>(x, y, player->get_symbol());
+        return Move<char>(x, y, player->get_symbol());
     }
     else {
-
-        int rx, ry;
-        Board<char>* b = player->get_board_ptr();
-        do {
-            rx = rand() % 7;
-            ry = rand() % 7;
-        } while (!((Diamond_X_O_Board*)b)->is_valid_cell(rx, ry) || b->get_cell(rx, ry) != '.');
-
-        return new Move<char>(rx, ry, player->get_symbol());
+        // computer: the player's agent picks a cell inside the diamond
+        return computer_move(player);
     }
 }
 
@@ -1771,21 +2222,37 @@ Player<char>* obstacles_XO_UI::create_player(string& name, char symbol, PlayerTy
     return new Player<char>(name, symbol, type);
 }
 
+/**
+ * @brief Creates the agent of a player; AI players use Monte Carlo tree
+ *        search, which copes with the random obstacles and
+ *        36 cells better than alpha-beta.
+ *
+ * @param type Player type.
+ * @param opponent The other player.
+ * @return The new agent, nullptr for a human.
+ */
+MoveAgent<char>* obstacles_XO_UI::create_agent(PlayerType type, Player<char>* opponent) {
+    if (type == PlayerType::AI)
+        return new MCTSAgent<char>(opponent, rng);
+    return UI<char>::create_agent(type, opponent);
+}
+
 /**
  * @brief Gets a move from player for Obstacle Tic Tac Toe.
  *
  * @param player Pointer to player.
- * @return Pointer to new move.
+ * @return The move read from the player.
  */
 
 
+/// Zobrist keys of Obstacles X-O.
+static const ZobristTable obstacles_keys(36, 1, 11);
+
 /**
  * @brief Constructs a 6x6 Obstacle X-O board with all cells blank.
  */
-obstacles_X_O_Board::obstacles_X_O_Board() : Board(6, 6) {
-    for (auto& row : board)
-        for (auto& cell : row)
-            cell = blank_symbol;
+obstacles_X_O_Board::obstacles_X_O_Board() {
+    init_hash(obstacles_keys);
 }
 
 /**
@@ -1794,116 +2261,29 @@ obstacles_X_O_Board::obstacles_X_O_Board() : Board(6, 6) {
  * Every second move (even @c n_moves), two random empty cells are turned into
  * obstacles ('#'). Obstacles cannot be used again.
  *
- * @param move Pointer to the move.
+ * @param move The move.
  * @return @c true if update succeeded, otherwise @c false.
  */
-bool obstacles_X_O_Board::update_board(Move<char>* move) {
-    int x = move->get_x();
-    int y = move->get_y();
-    char mark = move->get_symbol();
-    // Validate move and apply if valid
-    if (!(x < 0 || x >= rows || y < 0 || y >= columns) &&
-        (board[x][y] == blank_symbol || mark == 0)) {
-        if (mark == 0) { // Undo move
-            n_moves--;
-            board[x][y] = blank_symbol;
-        }
-        else {         // Apply move
-            n_moves++;
-            board[x][y] = toupper(mark);
-            if (n_moves % 2 == 0) {
-                int obstacles_placed = 0;
-                while (obstacles_placed < 2) {
-                    int rx = rand() % rows;
-                    int ry = rand() % columns;
-                    if (board[rx][ry] == blank_symbol) {
-                        board[rx][ry] = obstacle_symbol;
-                        obstacles_placed++;
-                    }
-                }
+bool obstacles_X_O_Board::update_board(const Move<char>& move) {
+    if (!place(move))
+        return false;
+
+    if (n_moves % 2 == 0) {
+        int obstacles_placed = 0;
+        while (obstacles_placed < 2) {
+            int rx = random().below(rows);
+            int ry = random().below(columns);
+            if (board[rx][ry] == BLANK) {
+                block(rx, ry);
+                obstacles_placed++;
             }
         }
     }
     return true;
 }
 
-/**
- * @brief Checks if the given player has a 4-in-a-row on Obstacle X-O board.
- *لا 
- * All horizontal, vertical and diagonal triples are checked, ignoring obstacles.
- *
- * @param player Pointer to player.
- * @return @c true if player has winning line, otherwise @c false.
- */
-bool obstacles_X_O_Board::is_win(Player<char>* player) {
-    const char sym = player->get_symbol();
-
-    // 4 in a row helper
-    auto all_equal4 = [&](char a, char b, char c, char d) {
-        return a == sym && a == b && b == c && c == d
-            && a != blank_symbol && a != obstacle_symbol;
-        };
-
-    // Check rows (horizontal)
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < columns - 3; ++j) { 
-            if (all_equal4(board[i][j], board[i][j + 1], board[i][j + 2], board[i][j + 3]))
-                return true;
-        }
-    }
-
-    // Check columns (vertical)
-    for (int j = 0; j < columns; ++j) {
-        for (int i = 0; i < rows - 3; ++i) {     
-            if (all_equal4(board[i][j], board[i + 1][j], board[i + 2][j], board[i + 3][j]))
-                return true;
-        }
-    }
-
-    // Check main diagonals (\)
-    for (int i = 0; i < rows - 3; ++i) {
-        for (int j = 0; j < columns - 3; ++j) {
-            if (all_equal4(board[i][j], board[i + 1][j + 1],
-                board[i + 2][j + 2], board[i + 3][j + 3]))
-                return true;
-        }
-    }
-
-    for (int i = 0; i < rows - 3; ++i) {
-        for (int j = 3; j < columns; ++j) { 
-            if (all_equal4(board[i][j], board[i + 1][j - 1],
-                board[i + 2][j - 2], board[i + 3][j - 3]))
-                return true;
-        }
-    }
-
-    return false;
-}
-
-
-/**
- * @brief Checks if Obstacle X-O is a draw.
- *
- * Draw occurs when all 36 cells are used with no winner.
- *
- * @param player Pointer to player.
- * @return @c true if draw, otherwise @c false.
- */
-bool obstacles_X_O_Board::is_draw(Player<char>* player) {
-    return (n_moves + 18 == 36 && !is_win(player));
-}
-
-/**
- * @brief Checks whether the Obstacle X-O game is over.
- *
- * @param player Pointer to player.
- * @return @c true if win or draw, otherwise @c false.
- */
-bool obstacles_X_O_Board::game_is_over(Player<char>* player) {
-    return is_win(player) || is_draw(player);
-}
 
-Move<char>* obstacles_XO_UI::get_move(Player<char>* player) {
+Move<char> obstacles_XO_UI::get_move(Player<char>* player) {
     int x, y;
     Board<char>* b = player->get_board_ptr();
 
@@ -1935,14 +2315,10 @@ Move<char>* obstacles_XO_UI::get_move(Player<char>* player) {
         }
     }
     else {
-        // computer random valid move
-        do {
-            x = rand() % 6;
-            y = rand() % 6;
-        } while (b->get_cell(x, y) != '.');
+        return computer_move(player);
     }
 
-    return new Move<char>(x, y, player->get_symbol());
+    return Move<char>(x, y, player->get_symbol());
 }
 
 // ------------------------------ 5x5 X-O board 
@@ -1966,298 +2342,205 @@ Player<char>* XO_UI_5::create_player(string& name, char symbol, PlayerType type)
  * @brief Gets a move from the player for 5x5 X-O.
  *
  * @param player Pointer to player.
- * @return Pointer to new move.
+ * @return The move read from the player.
  */
-Move<char>* XO_UI_5::get_move(Player<char>* player) {
+Move<char> XO_UI_5::get_move(Player<char>* player) {
     int x, y;
 
     if (player->get_type() == PlayerType::HUMAN) {
         cout << "\nPlease enter your move : ";
         cin >> x >> y;
     }
-    else if (player->get_type() == PlayerType::COMPUTER) {
-        x = rand() % player->get_board_ptr()->get_rows();
-        y = rand() % player->get_board_ptr()->get_columns();
+    else {
+        return computer_move(player);
     }
 
-    return new Move<char>(x, y, player->get_symbol());
+    return Move<char>(x, y, player->get_symbol());
 }
 
+/// Zobrist keys of 5x5 X-O.
+static const ZobristTable five_by_five_keys(25, 1, 12);
+
 /**
  * @brief Constructs a 5x5 X-O board with all cells blank.
  *
  * The game is scored by counting the number of 3-in-a-row lines for each player.
  */
-X_O_Board_5::X_O_Board_5() : Board(5, 5) {
-    for (int i = 0;i < rows;++i)
-        for (int j = 0;j < columns;++j)
-            board[i][j] = blank_symbol;
-    n_moves = 0;
+X_O_Board_5::X_O_Board_5() {
+    init_hash(five_by_five_keys);
+    init_symmetry(SquareSymmetry::of<5>());
 }
 
+//--------------------------------------------------- Ultimate_X_O_Board Implementation
+
+/// Zobrist keys of Ultimate X-O.
+static const ZobristTable ultimate_keys(81, 1, 13);
+
 /**
- * @brief Updates the 5x5 X-O board with a new move.
- *
- * The board does not allow moves after 24 total moves.
+ * @brief Constructs a 9x9 Ultimate X-O board with all cells blank.
  *
- * @param move Pointer to move.
- * @return @c true if move valid and applied, otherwise @c false.
+ * The board is composed of 9 sub-boards (3x3 each) forming a meta-game.
  */
-bool X_O_Board_5::update_board(Move<char>* move) {
-    int x = move->get_x(), y = move->get_y();
-    char mark = toupper(move->get_symbol());
-    if (x < 0 || x >= rows || y < 0 || y >= columns || n_moves == 24) return false;
-    if (board[x][y] != blank_symbol) return false;
-    board[x][y] = mark;
-    ++n_moves;
-    return true;
+Ultimate_X_O_Board::Ultimate_X_O_Board() {
+    board.fill(blank_symbol);
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            main_board[i][j] = '.';
+    init_hash(ultimate_keys);
 }
 
 /**
- * @brief Counts the number of 3-in-a-row lines for a given symbol on the 5x5 board.
+ * @brief Updates the 9x9 Ultimate X-O board with a move.
  *
- * All horizontal, vertical and diagonal triplets are considered.
+ * If the move completes a line in its sub-board, the sub-board is marked
+ * as won on @c main_board and its remaining empty cells are filled with
+ * '#'.
  *
- * @param sym The symbol to count lines for ('X' or 'O').
- * @return Number of 3-in-a-row occurrences.
+ * @param move The move.
+ * @return @c true if move is valid and applied, otherwise @c false.
  */
-int X_O_Board_5::count_three_in_row(char sym) {
-    int count = 0;
-    int rows = 5, cols = 5;
+bool Ultimate_X_O_Board::update_board(const Move<char>& move) {
+    int x = move.get_x();
+    int y = move.get_y();
+    char mark = toupper(move.get_symbol());
+    // Validate move and apply if valid
+    if (x < 0 || x >= rows || y < 0 || y >= columns || board[x][y] != blank_symbol)
+        return false;
 
-    auto check_three = [&](char a, char b, char c) {
-        return a == sym && b == sym && c == sym;
+    n_moves++;
+    set_cell(x, y, mark);
+
+    // A move can only complete a line in its own sub-board. When it does,
+    // the sub-board goes to the mover and its empty cells are closed.
+    int bi = x / 3, bj = y / 3;
+    int r = bi * 3, c = bj * 3;
+    auto all_mark = [&](char a, char b, char d) {
+        return a == mark && b == mark && d == mark;
         };
-
-
-    for (int r = 0; r < rows; r++) {
-        for (int c = 0; c <= cols - 3; c++) {
-            if (check_three(board[r][c], board[r][c + 1], board[r][c + 2])) {
-                count++;
-            }
-        }
-    }
-
-
-    for (int c = 0; c < cols; c++) {
-        for (int r = 0; r <= rows - 3; r++) {
-            if (check_three(board[r][c], board[r + 1][c], board[r + 2][c])) {
-                count++;
-            }
-        }
-    }
-
-
-    for (int r = 0; r <= rows - 3; r++) {
-        for (int c = 0; c <= cols - 3; c++) {
-            if (check_three(board[r][c], board[r + 1][c + 1], board[r + 2][c + 2])) {
-                count++;
-            }
-        }
-    }
-
-    for (int r = 0; r <= rows - 3; r++) {
-        for (int c = 2; c < cols; c++) {
-            if (check_three(board[r][c], board[r + 1][c - 1], board[r + 2][c - 2])) {
-                count++;
-            }
-        }
+    bool won = false;
+    for (int i = 0; i < 3; i++)
+        if (all_mark(board[r + i][c], board[r + i][c + 1], board[r + i][c + 2]) ||
+            all_mark(board[r][c + i], board[r + 1][c + i], board[r + 2][c + i]))
+            won = true;
+    if (all_mark(board[r][c], board[r + 1][c + 1], board[r + 2][c + 2]) ||
+        all_mark(board[r][c + 2], board[r + 1][c + 1], board[r + 2][c]))
+        won = true;
+
+    if (won && main_board[bi][bj] == '.') {
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++)
+                if (board[r + i][c + j] == blank_symbol) {
+                    set_cell(r + i, c + j, '#');
+                    ++n_filled;
+                }
+        main_board[bi][bj] = mark;
     }
 
-    return count;
-}
-
-/**
- * @brief Checks if the given player wins in 5x5 X-O by having more lines.
- *
- * After at least 24 moves, the total 3-in-a-row counts for 'X' and 'O'
- * are compared. The player wins iff their symbol has more lines.
- *
- * @param player Pointer to player.
- * @return @c true if the player wins, otherwise @c false.
- */
-bool X_O_Board_5::is_win(Player<char>* player) {
-    if (n_moves < 24) return false;
-
-    int xCount = count_three_in_row('X');
-    int oCount = count_three_in_row('O');
-
-    cout << xCount << " " << oCount << '\n';
-
-    if (xCount > oCount)   return player->get_symbol() == 'X';
-    if (oCount > xCount)   return player->get_symbol() == 'O';
-
-    return false;
+    return true;
 }
 
 /**
- * @brief Checks if the given player loses in 5x5 X-O by having fewer lines.
+ * @brief Packs the filled-cell counter and the meta-board for undo.
  *
- * @param player Pointer to player.
- * @return @c true if the player loses, otherwise @c false.
+ * Each meta cell takes 2 bits ('.', 'X' or 'O').
  */
-bool X_O_Board_5::is_lose(Player<char>* player) {
-    if (n_moves < 24) return false;
-
-    int xCount = count_three_in_row('X');
-    int oCount = count_three_in_row('O');
-
-    cout << xCount << " " << oCount << '\n';
-
-    if (xCount > oCount)   return player->get_symbol() == 'O';
-    if (oCount > xCount)   return player->get_symbol() == 'X';
-
-    return false;
+unsigned long long Ultimate_X_O_Board::save_derived_state() const {
+    unsigned long long state = n_filled;
+    for (int i = 0; i < 9; i++) {
+        char cell = main_board[i / 3][i % 3];
+        state |= static_cast<unsigned long long>(cell == 'X' ? 1 : cell == 'O' ? 2 : 0) << (8 + 2 * i);
+    }
+    return state;
 }
 
 /**
- * @brief Checks if the 5x5 X-O game is a draw.
- *
- * Draw occurs after 24 moves when both players have the same line count.
- *
- * @param player Pointer to player.
- * @return @c true if draw, otherwise @c false.
+ * @brief Restores the state saved by save_derived_state().
  */
-bool X_O_Board_5::is_draw(Player<char>* player) {
-    if (n_moves < 24) return false;
-    char me = toupper(player->get_symbol());
-    char opp = (me == 'X') ? 'O' : 'X';
-    cout << count_three_in_row(opp) << " " << count_three_in_row(me) << endl;
-    return count_three_in_row(me) == count_three_in_row(opp);
-
+void Ultimate_X_O_Board::restore_derived_state(unsigned long long state) {
+    static const char symbols[3] = { '.', 'X', 'O' };
+    n_filled = state & 0xFF;
+    for (int i = 0; i < 9; i++)
+        main_board[i / 3][i % 3] = symbols[(state >> (8 + 2 * i)) & 3];
 }
 
 /**
- * @brief Checks whether the 5x5 X-O game is over.
- *
- * Game is considered over after 24 moves, regardless of result.
- *
- * @param player Pointer to player.
- * @return @c true if game reached 24 moves, otherwise @c false.
+ * @brief Writes the filled-cell counter (7 bits) and the meta-board
+ *        (2 bits per cell).
  */
-bool X_O_Board_5::game_is_over(Player<char>* player) {
-    return n_moves >= 24;
+void Ultimate_X_O_Board::save_hidden(BitWriter& out) const {
+    unsigned long long state = save_derived_state();
+    out.put(state & 0xFF, 7);
+    out.put(state >> 8, 18);
 }
 
-//--------------------------------------------------- Ultimate_X_O_Board Implementation
-
 /**
- * @brief Constructs a 9x9 Ultimate X-O board with all cells blank.
+ * @brief Reads the state written by save_hidden(), packed as by
+ *        save_derived_state().
  *
- * The board is composed of 9 sub-boards (3x3 each) forming a meta-game.
+ * Each sub-board must be marked won exactly when it holds a line, by the
+ * owner of the line, closed cells ('#') must lie in won sub-boards only,
+ * and the filled-cell counter must count them.
  */
-Ultimate_X_O_Board::Ultimate_X_O_Board() : Board(9, 9) {
-    for (auto& row : board)
-        for (auto& cell : row)
-            cell = blank_symbol;
-}
+bool Ultimate_X_O_Board::read_hidden(BitReader& in, const SnapshotCells<char>& cells, int,
+                                     unsigned long long& hidden) const {
+    static const char symbols[3] = { '.', 'X', 'O' };
+    unsigned long long filled = in.get(7);
+    unsigned long long meta = in.get(18);
+    if (!in.ok()) return false;
 
-/**
- * @brief Prints the 3x3 meta-board of Ultimate X-O.
- *
- * Each meta cell represents the winner of a 3x3 sub-board:
- * - 'X' if X won,
- * - 'O' if O won,
- * - ' ' (space) otherwise.
- */
-void Ultimate_X_O_Board::print_meta_board() {
-    cout << "\nMeta Board (3x3):\n";
-    cout << "+---+---+---+\n";
-    for (int i = 0; i < 3; i++) {
-        cout << "| ";
-        for (int j = 0; j < 3; j++) {
-            char cell = main_board[i][j];
-            if (cell == '.') cell = ' ';
-            cout << cell << " | ";
+    unsigned long long closed = 0;
+    for (int b = 0; b < 9; ++b) {
+        unsigned long long code = (meta >> (2 * b)) & 3;
+        if (code == 3) return false;
+        int r = b / 3 * 3, c = b % 3 * 3;
+        char winner = '.';
+        for (char mark : { 'X', 'O' }) {
+            auto all_mark = [&](int x0, int y0, int x1, int y1, int x2, int y2) {
+                return cells.at(r + x0, c + y0) == mark && cells.at(r + x1, c + y1) == mark &&
+                       cells.at(r + x2, c + y2) == mark;
+                };
+            bool line = all_mark(0, 0, 1, 1, 2, 2) || all_mark(0, 2, 1, 1, 2, 0);
+            for (int i = 0; i < 3; ++i)
+                line = line || all_mark(i, 0, i, 1, i, 2) || all_mark(0, i, 1, i, 2, i);
+            if (line && winner != '.') return false;
+            if (line) winner = mark;
         }
-        cout << "\n+---+---+---+\n";
+        if (winner != symbols[code]) return false;
+        for (int i = 0; i < 9; ++i)
+            if (cells.at(r + i / 3, c + i % 3) == '#') {
+                if (code == 0) return false;
+                ++closed;
+            }
     }
+    if (filled != closed) return false;
+    hidden = filled | (meta << 8);
+    return true;
 }
 
 /**
- * @brief Updates the @c main_board meta-board based on sub-board winners.
- *
- * For each 3x3 block in the 9x9 board, a winner is determined and stored
- * in the corresponding meta cell.
+ * @brief Sets the state read by read_hidden().
  */
-void Ultimate_X_O_Board::update_meta_board() {
-
-    for (int i = 0; i < 3; i++)
-        for (int j = 0; j < 3; j++)
-            main_board[i][j] = '.';
-
-    auto check_winner = [&](int bi, int bj) -> char {
-        int r = bi * 3;
-        int c = bj * 3;
-
-        for (char sym : {'X', 'O'}) {
-            auto all_equal = [&](char a, char b, char c) {
-                return a == b && b == c && a == sym;
-                };
-
-            // Rows
-            for (int i = 0; i < 3; i++)
-                if (all_equal(board[r + i][c], board[r + i][c + 1], board[r + i][c + 2]))
-                    return sym;
-
-            // Columns
-            for (int j = 0; j < 3; j++)
-                if (all_equal(board[r][c + j], board[r + 1][c + j], board[r + 2][c + j]))
-                    return sym;
-
-            // Diagonals
-            if (all_equal(board[r][c], board[r + 1][c + 1], board[r + 2][c + 2]))
-                return sym;
-
-            if (all_equal(board[r][c + 2], board[r + 1][c + 1], board[r + 2][c]))
-                return sym;
-        }
-
-        return '.';
-        };
-
-    for (int bi = 0; bi < 3; bi++)
-        for (int bj = 0; bj < 3; bj++)
-            main_board[bi][bj] = check_winner(bi, bj);
+void Ultimate_X_O_Board::load_hidden(unsigned long long hidden) {
+    restore_derived_state(hidden);
 }
 
 /**
- * @brief Updates the 9x9 Ultimate X-O board with a move.
+ * @brief Lists every empty cell of the 9x9 board.
  *
- * After updating a cell, the meta board is recomputed and printed.
+ * Cells of sub-boards that are already won hold '#' and are never listed.
  *
- * @param move Pointer to move.
- * @return @c true if move is valid and applied, otherwise @c false.
+ * @param player Pointer to player.
+ * @param moves Receives the legal moves.
  */
-bool Ultimate_X_O_Board::update_board(Move<char>* move) {
-    int x = move->get_x();
-    int y = move->get_y();
-    char mark = move->get_symbol();
-    // Validate move and apply if valid
-    if (!(x < 0 || x >= rows || y < 0 || y >= columns) &&
-        (board[x][y] == blank_symbol || mark == 0)) {
-        if (mark == 0) { // Undo move
-            n_moves--;
-            board[x][y] = blank_symbol;
-        }
-        else {         // Apply move
-            n_moves++;
-            board[x][y] = toupper(mark);
-        }
-        update_meta_board();
-        print_meta_board();
-        return true;
-    }
-    return false;
+void Ultimate_X_O_Board::generate_moves(Player<char>* player, MoveList<char>& moves) {
+    list_empty_cells(blank_symbol, player->get_symbol(), moves);
 }
 
 /**
  * @brief Checks if the given player wins in the Ultimate X-O meta-game.
  *
- * The method:
- * 1. Determines which sub-boards the player has won and marks them on
- *    @c main_board.
- * 2. Checks if there is a 3-in-a-row on the meta-board for that player.
+ * Sub-board winners are recorded on @c main_board by update_board(), so
+ * this only looks for a 3-in-a-row on the meta-board for that player.
  *
  * @param player Pointer to player.
  * @return @c true if the player wins the meta-game, otherwise @c false.
@@ -2270,80 +2553,38 @@ bool Ultimate_X_O_Board::is_win(Player<char>* player) {
         return a == b && b == c && a == sym;
         };
 
-    // Reset main_board (3x3 meta-board)
+    // Rows and columns
     for (int i = 0; i < 3; i++)
-        for (int j = 0; j < 3; j++)
-            main_board[i][j] = '.'; // or blank_symbol
-
-    // ---- PHASE 1: Determine winners of all 3x3 sub-boards ----
-    for (int bi = 0; bi < 3; bi++) {
-        for (int bj = 0; bj < 3; bj++) {
-
-            int r = bi * 3;
-            int c = bj * 3;
-
-            bool won = false;
-
-            // Check rows
-            for (int i = 0; i < 3; i++)
-                if (all_equal(board[r + i][c], board[r + i][c + 1], board[r + i][c + 2]))
-                    won = true;
-
-            // Check columns
-            for (int j = 0; j < 3; j++)
-                if (all_equal(board[r][c + j], board[r + 1][c + j], board[r + 2][c + j]))
-                    won = true;
-
-            // Check diagonals
-            if (all_equal(board[r][c], board[r + 1][c + 1], board[r + 2][c + 2]))
-                won = true;
-            if (all_equal(board[r][c + 2], board[r + 1][c + 1], board[r + 2][c]))
-                won = true;
-
-            if (won) {
-                for (int i = 0; i < 3; i++)
-                    for (int j = 0; j < 3; j++)
-                        if (board[r + i][c + j] == blank_symbol) {
-                            board[r + i][c + j] = '#';
-                            ++y;
-                        }
-                main_board[bi][bj] = sym;
-            }
-        }
-    }
-
-    // ---- PHASE 2: Check win in the meta-board (3x3) ----
-
-    // Rows
-    for (int i = 0; i < 3; i++)
-        if (all_equal(main_board[i][0], main_board[i][1], main_board[i][2])) {
-            update_meta_board();
-            print_meta_board();
-            return true;
-        }
-
-    // Columns
-    for (int j = 0; j < 3; j++)
-        if (all_equal(main_board[0][j], main_board[1][j], main_board[2][j])) {
-            update_meta_board();
-            print_meta_board();
+        if (all_equal(main_board[i][0], main_board[i][1], main_board[i][2]) ||
+            all_equal(main_board[0][i], main_board[1][i], main_board[2][i]))
             return true;
-        }
 
     // Diagonals
-    if (all_equal(main_board[0][0], main_board[1][1], main_board[2][2])) {
-        update_meta_board();
-        print_meta_board();
-        return true;
-    }
-
-    if (all_equal(main_board[0][2], main_board[1][1], main_board[2][0])) {
-        update_meta_board();
-        print_meta_board();
-        return true;
-    }
+    return all_equal(main_board[0][0], main_board[1][1], main_board[2][2]) ||
+        all_equal(main_board[0][2], main_board[1][1], main_board[2][0]);
+}
 
-    return false;
+/**
+ * @brief Heuristic score of the Ultimate X-O position for a player.
+ *
+ * Every sub-board won by the player adds its weight on the meta-board
+ * (centre 4, corners 3, edges 2) and every one won by the opponent
+ * subtracts it. The score is scaled by 10.
+ *
+ * @param player Pointer to the player.
+ * @return Heuristic score, positive when the player is ahead.
+ */
+int Ultimate_X_O_Board::evaluate(Player<char>* player) {
+    static const int weight[3][3] = { { 3, 2, 3 }, { 2, 4, 2 }, { 3, 2, 3 } };
+    char sym = player->get_symbol();
+    int score = 0;
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            if (main_board[i][j] == sym)
+                score += weight[i][j];
+            else if (main_board[i][j] != '.')
+                score -= weight[i][j];
+    return 10 * score;
 }
 
 /**
@@ -2356,7 +2597,7 @@ bool Ultimate_X_O_Board::is_win(Player<char>* player) {
  * @return @c true if draw, otherwise @c false.
  */
 bool Ultimate_X_O_Board::is_draw(Player<char>* player) {
-    return ((n_moves + y) == 81 && !is_win(player));
+    return ((n_moves + n_filled) == 81 && !is_win(player));
 }
 
 /**
@@ -2385,22 +2626,118 @@ Player<char>* Ultimate_X_O_UI::create_player(string& name, char symbol, PlayerTy
     return new Player<char>(name, symbol, type);
 }
 
+/**
+ * @brief Creates the agent of a player; AI players use Monte Carlo tree
+ *        search, which copes with up to 81 moves per ply
+ *        better than alpha-beta.
+ *
+ * @param type Player type.
+ * @param opponent The other player.
+ * @return The new agent, nullptr for a human.
+ */
+MoveAgent<char>* Ultimate_X_O_UI::create_agent(PlayerType type, Player<char>* opponent) {
+    if (type == PlayerType::AI)
+        return new MCTSAgent<char>(opponent, rng);
+    return UI<char>::create_agent(type, opponent);
+}
+
 /**
  * @brief Gets a move from the player for Ultimate X-O.
  *
  * @param player Pointer to player.
- * @return Pointer to new move.
+ * @return The move read from the player.
  */
-Move<char>* Ultimate_X_O_UI::get_move(Player<char>* player) {
+Move<char> Ultimate_X_O_UI::get_move(Player<char>* player) {
     int x, y;
     if (player->get_type() == PlayerType::HUMAN) {
         cout << "\nEnter your move for Ultimate X-O (row col): ";
         cin >> x >> y;
     }
     else {
-        // computer random move
-        x = rand() % player->get_board_ptr()->get_rows();
-        y = rand() % player->get_board_ptr()->get_columns();
+        return computer_move(player);
     }
-    return new Move<char>(x, y, player->get_symbol());
+    return Move<char>(x, y, player->get_symbol());
+}
+
+/**
+ * @brief Displays the 9x9 board followed by the 3x3 meta-board.
+ *
+ * The meta-board is rebuilt from the view: a sub-board belongs to the
+ * player with a completed line in it.
+ *
+ * @param matrix View of the 9x9 board.
+ */
+void Ultimate_X_O_UI::display_board_matrix(const BoardView<char>& matrix) const {
+    UI<char>::display_board_matrix(matrix);
+    if (matrix.get_rows() != 9 || matrix.get_columns() != 9) return;
+
+    char main_board[3][3];
+    for (int bi = 0; bi < 3; bi++) {
+        for (int bj = 0; bj < 3; bj++) {
+            int r = bi * 3, c = bj * 3;
+            main_board[bi][bj] = '.';
+            for (char sym : {'X', 'O'}) {
+                auto all_sym = [&](char a, char b, char d) {
+                    return a == sym && b == sym && d == sym;
+                    };
+                bool won = all_sym(matrix[r][c], matrix[r + 1][c + 1], matrix[r + 2][c + 2]) ||
+                    all_sym(matrix[r][c + 2], matrix[r + 1][c + 1], matrix[r + 2][c]);
+                for (int i = 0; i < 3; i++)
+                    won = won || all_sym(matrix[r + i][c], matrix[r + i][c + 1], matrix[r + i][c + 2]) ||
+                        all_sym(matrix[r][c + i], matrix[r + 1][c + i], matrix[r + 2][c + i]);
+                if (won)
+                    main_board[bi][bj] = sym;
+            }
+        }
+    }
+    display_main_board(main_board);
+}
+
+/**
+ * @brief Prints the 3x3 meta-board ('.' cells are shown empty).
+ *
+ * @param main_board Winner of each sub-board.
+ */
+void Ultimate_X_O_UI::display_main_board(char main_board[3][3]) const {
+    cout << "\nMeta Board (3x3):\n";
+    cout << "+---+---+---+\n";
+    for (int i = 0; i < 3; i++) {
+        cout << "| ";
+        for (int j = 0; j < 3; j++) {
+            char cell = main_board[i][j];
+            if (cell == '.') cell = ' ';
+            cout << cell << " | ";
+        }
+        cout << "\n+---+---+---+\n";
+    }
+}
+
+//--------------------------------------------------- Variant table
+
+/**
+ * @brief Returns variant @p index of the collection.
+ *
+ * The table follows the XO_Demo menu, so menu choice @c n is variant
+ * @c n - 1.
+ *
+ * @param index Variant index, 0 to XO_VARIANT_COUNT - 1.
+ * @return The variant's name, player symbols and board factory.
+ */
+const XO_Variant& xo_variant(int index) {
+    static const XO_Variant variants[XO_VARIANT_COUNT] = {
+        { "SUS",                     { 'S', 'U' }, []() -> Board<char>* { return new SUS_Board(); } },
+        { "Four-in-a-row",           { 'X', 'O' }, []() -> Board<char>* { return new Connect4_Board(); } },
+        { "5 x 5 Tic Tac Toe",       { 'X', 'O' }, []() -> Board<char>* { return new X_O_Board_5(); } },
+        { "Word Tic-tac-toe",        { 'X', 'O' }, []() -> Board<char>* { return new X_O_Board_WORD(); } },
+        { "Misere Tic Tac Toe",      { 'X', 'O' }, []() -> Board<char>* { return new X_O_Inverse_Board(); } },
+        { "Diamond Tic-Tac-Toe",     { 'X', 'O' }, []() -> Board<char>* { return new Diamond_X_O_Board(); } },
+        { "4 x 4 Tic-Tac-Toe",       { 'X', 'O' }, []() -> Board<char>* { return new X_O_Board4(); } },
+        { "Pyramid Tic-Tac-Toe",     { 'X', 'O' }, []() -> Board<char>* { return new Pyramid_X_O_Board(); } },
+        { "Numerical Tic-Tac-Toe",   { 'X', 'O' }, []() -> Board<char>* { return new X_O_Num_Board(); } },
+        { "Obstacles Tic-Tac-Toe",   { 'X', 'O' }, []() -> Board<char>* { return new obstacles_X_O_Board(); } },
+        { "Infinity Tic-Tac-Toe",    { 'X', 'O' }, []() -> Board<char>* { return new X_O_Board(); } },
+        { "Ultimate Tic Tac Toe",    { 'X', 'O' }, []() -> Board<char>* { return new Ultimate_X_O_Board(); } },
+        { "Memory Tic-Tac-Toe",      { 'X', 'O' }, []() -> Board<char>* { return new Memo_X_O_Board(); } },
+    };
+    return variants[index];
 }
@@ -1,4 +1,6 @@
 #include "BoardGame_Classes.h"
+#include "BoardGame_MNK.h"
+#include "BoardGame_MCTS.h"
 #include <queue>      // For std::queue
 #include <utility>    // For std::pair
 #include <map>
@@ -18,8 +20,6 @@
  *  - a UI<char>-derived class that interacts with the player(s).
  */
 
-extern std::unordered_set<std::string> s;
-
 using namespace std;
 
 /**
@@ -30,22 +30,50 @@ using namespace std;
  * remain on the board. Older moves are automatically removed after the
  * 7th move is played.
  */
-class X_O_Board : public Board<char> {
+class X_O_Board final : public FixedBoard<char, 3, 3> {
 private:
+    typedef LineTable<3, 3, 3> Lines; ///< Rows, columns and diagonals
     char blank_symbol = '.';
-    /// Queue used to remember the order of moves so old ones can be removed.
-    queue<pair<int, int>> movelist;
+    /// Ring buffer of cell indices remembering the order of moves so old ones can be removed.
+    int movelist[8] = {};
+    /// Slot of the oldest move in @c movelist.
+    int queue_head = 0;
+    /// Number of moves currently in @c movelist.
+    int queue_size = 0;
+
+protected:
+    unsigned long long save_derived_state() const override;
+    void restore_derived_state(unsigned long long state) override;
+    unsigned long long derived_hash(int transform) const override;
+    CellAlphabet<char> cell_alphabet() const override { return CellAlphabet<char>(".XO", 3); }
+    void save_hidden(BitWriter& out) const override;
+    bool read_hidden(BitReader& in, const SnapshotCells<char>& cells, int moves,
+                     unsigned long long& hidden) const override;
+    void load_hidden(unsigned long long hidden) override;
 
 public:
     /// Constructs an empty 3x3 infinity board.
     X_O_Board();
+    Board<char>* clone() const override { return new X_O_Board(*this); }
+
+    /// Perfect index of the positions, for tablebases (see Board::position_count).
+    long long position_count() const override;
+    long long position_index() const override;
+    bool set_position(long long index) override;
 
     /**
      * @brief Updates the board with the given move.
-     * @param move Pointer to the move to play (or undo if symbol == 0).
+     * @param move The move to play.
      * @return true if the move was valid and applied, false otherwise.
      */
-    bool update_board(Move<char>* move);
+    bool update_board(const Move<char>& move);
+
+    /**
+     * @brief Lists a placement on every empty cell.
+     * @param player Player to move.
+     * @param moves Receives the legal moves.
+     */
+    void generate_moves(Player<char>* player, MoveList<char>& moves);
 
     /**
      * @brief Checks whether the given player currently has 3 in a row.
@@ -97,23 +125,22 @@ public:
     /**
      * @brief Reads the next move from the given player.
      * @param player Player whose move is requested.
-     * @return Newly allocated Move object.
+     * @return The move read from the player.
      */
-    virtual Move<char>* get_move(Player<char>* player);
+    virtual Move<char> get_move(Player<char>* player);
 };
 
 /**
  * @class DirectedMove
- * @brief Specialized move that also stores a direction.
+ * @brief Move that slides a piece one step in a direction.
  *
  * Used by the 4x4 sliding X-O variant where pieces move one step in
  * a given direction (L, R, U, D) instead of being placed freely.
+ * The direction is stored in the base Move value itself, so a
+ * DirectedMove can be passed and copied as a plain Move<char>.
  */
 class DirectedMove : public Move<char>
 {
-    /// Direction of movement: 'L', 'R', 'U', or 'D'.
-    char direction;
-
 public:
     /**
      * @brief Constructs a directed move.
@@ -123,15 +150,7 @@ public:
      * @param dir Direction to move in ('L','R','U','D').
      */
     DirectedMove(int x, int y, char symbol, char dir)
-        : Move<char>(x, y, symbol), direction(dir) {}
-
-    /**
-     * @brief Gets the direction of this move.
-     * @return Stored direction character.
-     */
-    char get_direction() const {
-        return direction;
-    }
+        : Move<char>(x, y, symbol, dir) {}
 };
 
 /**
@@ -141,20 +160,33 @@ public:
  * Pieces start pre-placed on the first and last rows and players move
  * their symbols one step at a time trying to make 3-in-a-row.
  */
-class X_O_Board4 : public Board<char> {
+class X_O_Board4 final : public FixedBoard<char, 4, 4> {
 private:
+    typedef LineTable<4, 4, 3> Lines; ///< The 24 three-in-a-row lines
     char blank_symbol = '.';
 
+protected:
+    CellAlphabet<char> cell_alphabet() const override { return CellAlphabet<char>(".XO", 3); }
+
 public:
     /// Initializes the 4x4 board with the starting configuration.
     X_O_Board4();
+    Board<char>* clone() const override { return new X_O_Board4(*this); }
+
+    /// Perfect index of the positions, for tablebases (see Board::position_count).
+    long long position_count() const override;
+    long long position_index() const override;
+    bool set_position(long long index) override;
 
     /**
      * @brief Applies a directed move on the board.
-     * @param move Pointer to a DirectedMove object.
+     * @param move Move carrying the source cell and direction.
      * @return true if the move was valid and applied, false otherwise.
      */
-    bool update_board(Move<char>* move);
+    bool update_board(const Move<char>& move);
+
+    /// Lists every one-step slide of the player's pieces into an empty cell.
+    void generate_moves(Player<char>* player, MoveList<char>& moves);
 
     /**
      * @brief Checks if the given player has a winning line.
@@ -186,7 +218,7 @@ public:
     Player<char>* create_player(string& name, char symbol, PlayerType type);
 
     /// Gets a DirectedMove (row, column, direction) from the player.
-    virtual Move<char>* get_move(Player<char>* player);
+    virtual Move<char> get_move(Player<char>* player);
 };
 
 /**
@@ -197,22 +229,44 @@ public:
  * uses even numbers. A player "wins" if any row/column/diagonal
  * sums to 15 (magic square rule).
  */
-class X_O_Num_Board : public Board<char> {
+class X_O_Num_Board final : public FixedBoard<char, 3, 3> {
 private:
     char blank_symbol = '0';
-    /// Tracks which numbers 1–9 have been used already.
-    map<int, bool> used_numbers;
+    /// Bit d is set once digit d (1–9) has been used.
+    unsigned short used_numbers = 0;
+
+protected:
+    unsigned long long save_derived_state() const override;
+    void restore_derived_state(unsigned long long state) override;
+    CellAlphabet<char> cell_alphabet() const override { return CellAlphabet<char>("0123456789", 10); }
+    void save_hidden(BitWriter& out) const override;
+    bool read_hidden(BitReader& in, const SnapshotCells<char>& cells, int moves,
+                     unsigned long long& hidden) const override;
+    void load_hidden(unsigned long long hidden) override;
 
 public:
     /// Constructs an empty 3x3 numerical board and clears usage map.
     X_O_Num_Board();
+    Board<char>* clone() const override { return new X_O_Num_Board(*this); }
+
+    /// Perfect index of the positions, for tablebases (see Board::position_count).
+    long long position_count() const override;
+    long long position_index() const override;
+    bool set_position(long long index) override;
 
     /**
      * @brief Places a digit on the board (respecting parity rules).
      * @param move Move containing (row, column, digit).
      * @return true if the move was valid and applied, false otherwise.
      */
-    bool update_board(Move<char>* move);
+    bool update_board(const Move<char>& move);
+
+    /**
+     * @brief Lists every unused digit of the right parity on every empty cell.
+     * @param player Player to move (the parity comes from the move count).
+     * @param moves Receives the legal moves.
+     */
+    void generate_moves(Player<char>* player, MoveList<char>& moves);
 
     /**
      * @brief Checks if the board contains a line summing to 15.
@@ -245,7 +299,7 @@ public:
     Player<char>* create_player(string& name, char symbol, PlayerType type);
 
     /// Reads (row, column, digit) from the player.
-    virtual Move<char>* get_move(Player<char>* player);
+    virtual Move<char> get_move(Player<char>* player);
 };
 
 /**
@@ -255,20 +309,36 @@ public:
  * Players place letters 'S' and 'U' trying to create the word "SUS"
  * in multiple lines; the winner is the player with more SUS triples.
  */
-class SUS_Board : public Board<char> {
+class SUS_Board final : public FixedBoard<char, 3, 3> {
 private:
     char blank_symbol = '.';
     /// Count SUS made by each player to detect the winner.
     int sus_count[2] = { 0,0 };
+    /// Bit i is set once SUS line i + 1 (see check()) has been counted.
+    unsigned char claimed = 0;
+
+protected:
+    unsigned long long save_derived_state() const override;
+    void restore_derived_state(unsigned long long state) override;
+    unsigned long long derived_hash(int) const override;
+    CellAlphabet<char> cell_alphabet() const override { return CellAlphabet<char>(".SU", 3); }
+    void save_hidden(BitWriter& out) const override;
+    bool read_hidden(BitReader& in, const SnapshotCells<char>& cells, int moves,
+                     unsigned long long& hidden) const override;
+    void load_hidden(unsigned long long hidden) override;
 
 public:
     SUS_Board();
+    Board<char>* clone() const override { return new SUS_Board(*this); }
 
     /// Places letter on board and updates move count.
-    bool update_board(Move<char>* move);
+    bool update_board(const Move<char>& move);
+
+    /// Lists the player's letter on every empty cell.
+    void generate_moves(Player<char>* player, MoveList<char>& moves);
 
     /**
-     * @brief Counts new SUS lines and determines the winner.
+     * @brief Determines the winner from the SUS lines counted so far.
      * @param player Player to test from their perspective.
      * @return true if this player has strictly more SUS triples.
      */
@@ -311,7 +381,7 @@ public:
     Player<char>** setup_players() override;
 
     /// Reads a move (row, col) from the player.
-    virtual Move<char>* get_move(Player<char>* player);
+    virtual Move<char> get_move(Player<char>* player);
 };
 
 /**
@@ -324,22 +394,33 @@ public:
  *
  * @see Board
  */
-class X_O_Inverse_Board : public Board<char> {
+class X_O_Inverse_Board final : public FixedBoard<char, 3, 3> {
 private:
     char blank_symbol = '.'; ///< Character used to represent an empty cell on the board.
 
+protected:
+    CellAlphabet<char> cell_alphabet() const override { return CellAlphabet<char>(".XO", 3); }
+
 public:
     /**
      * @brief Default constructor that initializes a 3x3 X-O board.
      */
     X_O_Inverse_Board();
+    Board<char>* clone() const override { return new X_O_Inverse_Board(*this); }
 
     /**
      * @brief Updates the board with a player's move.
-     * @param move Pointer to a Move<char> object containing move coordinates and symbol.
+     * @param move Move<char> value containing move coordinates and symbol.
      * @return true if the move is valid and successfully applied, false otherwise.
      */
-    bool update_board(Move<char>* move);
+    bool update_board(const Move<char>& move);
+
+    /**
+     * @brief Lists a placement on every empty cell.
+     * @param player Pointer to the player to move.
+     * @param moves Receives the legal moves.
+     */
+    void generate_moves(Player<char>* player, MoveList<char>& moves);
 
     /**
      * @brief Checks if the given player has won the game.
@@ -406,9 +487,9 @@ public:
     /**
      * @brief Retrieves the next move from a player.
      * @param player Pointer to the player whose move is being requested.
-     * @return A pointer to a new `Move<char>` object representing the player's action.
+     * @return A `Move<char>` value representing the player's action.
      */
-    virtual Move<char>* get_move(Player<char>* player);
+    virtual Move<char> get_move(Player<char>* player);
 };
 
 /**
@@ -418,12 +499,24 @@ public:
  * Only specific positions are playable; winning patterns follow the
  * pyramid geometry rather than a simple rectangle.
  */
-class Pyramid_X_O_Board : public Board<char> {
+class Pyramid_X_O_Board final : public FixedBoard<char, 3, 5> {
 private:
+    /// Lines of three within the pyramid (cells (0,2), (1,1..3) and row 2)
+    typedef LineTable<3, 5, 3, LINE_ALL, 0x7DC4> Lines;
     char blank_symbol = '.';
+protected:
+    CellAlphabet<char> cell_alphabet() const override { return CellAlphabet<char>(".XO*", 4); }
+
 public:
     Pyramid_X_O_Board();
-    bool update_board(Move<char>* move);
+    Board<char>* clone() const override { return new Pyramid_X_O_Board(*this); }
+
+    /// Perfect index of the positions, for tablebases (see Board::position_count).
+    long long position_count() const override;
+    long long position_index() const override;
+    bool set_position(long long index) override;
+    bool update_board(const Move<char>& move);
+    void generate_moves(Player<char>* player, MoveList<char>& moves);
     bool is_win(Player<char>* player);
     bool is_lose(Player<char>*);
     bool is_draw(Player<char>* player);
@@ -439,7 +532,7 @@ public:
     Pyramid_XO_UI();
     ~Pyramid_XO_UI() {};
     Player<char>* create_player(string& name, char symbol, PlayerType type);
-    virtual Move<char>* get_move(Player<char>* player);
+    virtual Move<char> get_move(Player<char>* player);
 };
 
 /**
@@ -453,7 +546,7 @@ public:
     XO_UI_WORD();
     ~XO_UI_WORD() {};
     Player<char>* create_player(string& name, char symbol, PlayerType type);
-    virtual Move<char>* get_move(Player<char>* player);
+    virtual Move<char> get_move(Player<char>* player);
 };
 
 
@@ -464,13 +557,18 @@ public:
  * Each line on the board represents a 3-letter word. A player wins
  * if any row/column/diagonal forms a valid word from the dictionary.
  */
-class X_O_Board_WORD : public Board<char> {
+class X_O_Board_WORD final : public FixedBoard<char, 3, 3> {
 private:
     char blank_symbol = '.';
 
+protected:
+    CellAlphabet<char> cell_alphabet() const override { return CellAlphabet<char>(".ABCDEFGHIJKLMNOPQRSTUVWXYZ", 27); }
+
 public:
     X_O_Board_WORD();
-    bool update_board(Move<char>* move);
+    Board<char>* clone() const override { return new X_O_Board_WORD(*this); }
+    bool update_board(const Move<char>& move);
+    void generate_moves(Player<char>* player, MoveList<char>& moves);
     bool is_win(Player<char>* player);
     bool is_draw(Player<char>* player);
     bool is_lose(Player<char>*) { return false; };
@@ -482,29 +580,14 @@ public:
  * @brief Standard 6x7 Connect Four board.
  *
  * Simulates gravity: discs must be placed on top of existing ones and
- * a player wins by connecting four of their symbols.
+ * a player wins by connecting four of their symbols. All rules come from
+ * MNKBoard.
  */
-class Connect4_Board : public Board<char> {
-private:
-    char blank_symbol = '.'; ///< Character used to represent an empty cell on the board.
-
+class Connect4_Board final : public MNKBoard<6, 7, 4, MNK_GRAVITY> {
 public:
     /// Constructs an empty 6x7 Connect Four board.
     Connect4_Board();
-
-    /// Places a disc if the move respects gravity and bounds.
-    bool update_board(Move<char>* move);
-
-    /// Checks if the given player has 4 connected symbols.
-    bool is_win(Player<char>* player);
-
-    bool is_lose(Player<char>*) { return false; };
-
-    /// Checks for draw (board full with no winner).
-    bool is_draw(Player<char>* player);
-
-    /// Returns true if game ended (win or draw).
-    bool game_is_over(Player<char>* player);
+    Board<char>* clone() const override { return new Connect4_Board(*this); }
 };
 
 
@@ -521,7 +604,7 @@ public:
     Player<char>* create_player(string& name, char symbol, PlayerType type);
 
     /// Reads a move (row, column) from the player.
-    virtual Move<char>* get_move(Player<char>* player);
+    virtual Move<char> get_move(Player<char>* player);
 };
 
 /**
@@ -531,15 +614,27 @@ public:
  * Stores the real symbols in a hidden grid while showing only masked
  * cells ('#') to the players; win detection uses the hidden board.
  */
-class Memo_X_O_Board : public Board<char> {
+class Memo_X_O_Board final : public FixedBoard<char, 3, 3> {
 private:
     char blank_symbol = '.';
+    typedef LineTable<3, 3, 3> Lines; ///< Rows, columns and diagonals of the hidden board
     /// Hidden "real" board storing actual symbols.
-    vector<vector<char>> revealed;
+    FixedGrid<char, 3, 3> revealed;
+
+protected:
+    void restore_derived_state(unsigned long long state) override;
+    unsigned long long derived_hash(int transform) const override;
+    CellAlphabet<char> cell_alphabet() const override { return CellAlphabet<char>(".#", 2); }
+    void save_hidden(BitWriter& out) const override;
+    bool read_hidden(BitReader& in, const SnapshotCells<char>& cells, int moves,
+                     unsigned long long& hidden) const override;
+    void load_hidden(unsigned long long hidden) override;
 
 public:
     Memo_X_O_Board();
-    bool update_board(Move<char>* move);
+    Board<char>* clone() const override { return new Memo_X_O_Board(*this); }
+    bool update_board(const Move<char>& move);
+    void generate_moves(Player<char>* player, MoveList<char>& moves);
     bool is_win(Player<char>* player);
     bool is_lose(Player<char>*) { return false; };
     bool is_draw(Player<char>* player);
@@ -555,7 +650,7 @@ public:
     Memo_XO_UI();
     ~Memo_XO_UI() {};
     Player<char>* create_player(string& name, char symbol, PlayerType type);
-    virtual Move<char>* get_move(Player<char>* player);
+    virtual Move<char> get_move(Player<char>* player);
 };
 
 /**
@@ -566,15 +661,20 @@ public:
  * wins by creating one 3-cell line and one 4-cell line that intersect
  * in exactly one cell.
  */
-class Diamond_X_O_Board : public Board<char> {
+class Diamond_X_O_Board final : public FixedBoard<char, 7, 7> {
 private:
     char blank_symbol = '.';
+protected:
+    CellAlphabet<char> cell_alphabet() const override { return CellAlphabet<char>(".XO$", 4); }
+
 public:
     /// Type alias for a line of cells.
     typedef std::vector<std::pair<int, int>> Line;
 
     Diamond_X_O_Board();
-    bool update_board(Move<char>* move) override;
+    Board<char>* clone() const override { return new Diamond_X_O_Board(*this); }
+    bool update_board(const Move<char>& move) override;
+    void generate_moves(Player<char>* player, MoveList<char>& moves) override;
     bool is_win(Player<char>* player) override;
     bool is_draw(Player<char>* player) override;
     bool game_is_over(Player<char>* player) override;
@@ -607,7 +707,8 @@ class Diamond_X_O_UI : public UI<char> {
 public:
     Diamond_X_O_UI();
     Player<char>* create_player(string& name, char symbol, PlayerType type);
-    virtual Move<char>* get_move(Player<char>* player);
+    virtual Move<char> get_move(Player<char>* player);
+    MoveAgent<char>* create_agent(PlayerType type, Player<char>* opponent) override;
 };
 
 
@@ -616,19 +717,15 @@ public:
  * @brief 6x6 Tic-Tac-Toe board with random obstacles.
  *
  * After every second move, two random cells turn into permanent
- * obstacles ('#'), shrinking the available space on the board.
+ * obstacles ('#'), shrinking the available space on the board. Four in
+ * a row wins; lines and draws come from MNKBoard.
  */
-class obstacles_X_O_Board : public Board<char> {
-private:
-    char blank_symbol = '.';
-    char obstacle_symbol = '#';
+class obstacles_X_O_Board final : public MNKBoard<6, 6, 4> {
 public:
     obstacles_X_O_Board();
-    bool update_board(Move<char>* move);
-    bool is_win(Player<char>* player);
-    bool is_lose(Player<char>*) { return false; };
-    bool is_draw(Player<char>* player);
-    bool game_is_over(Player<char>* player);
+    Board<char>* clone() const override { return new obstacles_X_O_Board(*this); }
+    /// Places the move, then two obstacles after every second move.
+    bool update_board(const Move<char>& move) override;
 };
 
 /**
@@ -640,33 +737,22 @@ public:
     obstacles_XO_UI();
     ~obstacles_XO_UI() {};
     Player<char>* create_player(string& name, char symbol, PlayerType type);
-    virtual Move<char>* get_move(Player<char>* player);
+    virtual Move<char> get_move(Player<char>* player);
+    MoveAgent<char>* create_agent(PlayerType type, Player<char>* opponent) override;
 };
 
 /**
  * @class X_O_Board_5
  * @brief 5x5 Tic-Tac-Toe board scored by number of 3-in-a-rows.
  *
- * After the board is almost full, each player's score is the number
- * of distinct 3-cell lines they have; the higher score wins.
+ * After the board is almost full (24 moves), each player's score is the
+ * number of distinct 3-cell lines they have; the higher score wins. All
+ * rules come from MNKBoard's scoring mode.
  */
-class X_O_Board_5 : public Board<char> {
+class X_O_Board_5 final : public MNKBoard<5, 5, 3, MNK_SCORE> {
 public:
     X_O_Board_5();
-    bool update_board(Move<char>* move);
-    bool is_win(Player<char>* player);
-    bool is_draw(Player<char>* player);
-    bool is_lose(Player<char>* player);
-    bool game_is_over(Player<char>* player);
-private:
-    /**
-     * @brief Counts all 3-in-a-row lines for a given symbol.
-     * @param sym 'X' or 'O'.
-     * @return Number of distinct 3-cell lines.
-     */
-    int count_three_in_row(char sym);
-
-    char blank_symbol = '.';
+    Board<char>* clone() const override { return new X_O_Board_5(*this); }
 };
 
 
@@ -679,7 +765,7 @@ public:
     XO_UI_5();
     ~XO_UI_5() {};
     Player<char>* create_player(string& name, char symbol, PlayerType type);
-    virtual Move<char>* get_move(Player<char>* player);
+    virtual Move<char> get_move(Player<char>* player);
 };
 
 /**
@@ -689,27 +775,36 @@ public:
  * The board is divided into 3x3 sub-boards; each sub-board behaves
  * like a mini Tic-Tac-Toe whose winner fills a cell in the meta-board.
  */
-class Ultimate_X_O_Board : public Board<char> {
+class Ultimate_X_O_Board final : public FixedBoard<char, 9, 9> {
 private:
     char blank_symbol = '.';
     /// Meta-board of 3x3 representing winners of sub-boards.
     char main_board[3][3];
-    /// Internal helper state used for sub-board targeting.
-    int y = 0;
+    /// Number of empty cells closed with '#' because their sub-board was won.
+    int n_filled = 0;
+
+protected:
+    unsigned long long save_derived_state() const override;
+    void restore_derived_state(unsigned long long state) override;
+    CellAlphabet<char> cell_alphabet() const override { return CellAlphabet<char>(".XO#", 4); }
+    void save_hidden(BitWriter& out) const override;
+    bool read_hidden(BitReader& in, const SnapshotCells<char>& cells, int moves,
+                     unsigned long long& hidden) const override;
+    void load_hidden(unsigned long long hidden) override;
+
 public:
     Ultimate_X_O_Board();
+    Board<char>* clone() const override { return new Ultimate_X_O_Board(*this); }
 
-    /// Prints the current meta-board (3x3 winners).
-    void print_meta_board();
-
-    /// Updates the meta-board according to won sub-boards.
-    void update_meta_board();
-
-    bool update_board(Move<char>* move) override;
+    bool update_board(const Move<char>& move) override;
+    void generate_moves(Player<char>* player, MoveList<char>& moves) override;
     bool is_win(Player<char>* player) override;
     bool is_draw(Player<char>* player) override;
     bool game_is_over(Player<char>* player) override;
     bool is_lose(Player<char>*) override { return false; }
+
+    /// Scores the won sub-boards, the centre counting most.
+    int evaluate(Player<char>* player) override;
 };
 
 /**
@@ -724,11 +819,62 @@ public:
     Player<char>* create_player(string& name, char symbol, PlayerType type) override;
 
     /// Reads a move from the player (board + cell).
-    virtual Move<char>* get_move(Player<char>* player) override;
+    virtual Move<char> get_move(Player<char>* player) override;
+
+    /// Displays the 9x9 board and, below it, the 3x3 meta-board.
+    void display_board_matrix(const BoardView<char>& matrix) const override;
 
     /// Displays the 3x3 meta-board.
-    void display_main_board(char main_board[3][3]);
+    void display_main_board(char main_board[3][3]) const;
+
+    /// Gives AI players a Monte Carlo tree search agent.
+    MoveAgent<char>* create_agent(PlayerType type, Player<char>* opponent) override;
+};
+
+/**
+ * @struct XO_Variant
+ * @brief One entry of the variant table used by batch drivers.
+ */
+struct XO_Variant {
+    const char* name;          ///< Menu name of the variant
+    char symbols[2];           ///< Symbols of the first and second player
+    Board<char>* (*create)();  ///< Allocates a fresh board of the variant
 };
 
+/// Number of variants in the table.
+const int XO_VARIANT_COUNT = 13;
+
+/// Returns variant @p index (0-based, in XO_Demo menu order).
+const XO_Variant& xo_variant(int index);
+
+/**
+ * @brief Calls @p f with a fresh board of variant @p index, by its concrete type.
+ *
+ * The board lives on the stack for the duration of the call. Since every
+ * X-O board class is final, code that @p f instantiates for it (such as
+ * StaticGameManager) calls the board without virtual dispatch.
+ *
+ * @param index Variant index, as for xo_variant.
+ * @param f Generic callable taking the board by reference.
+ */
+template <typename F>
+void with_variant_board(int index, F&& f) {
+    switch (index) {
+    case 0:  { SUS_Board b; f(b); break; }
+    case 1:  { Connect4_Board b; f(b); break; }
+    case 2:  { X_O_Board_5 b; f(b); break; }
+    case 3:  { X_O_Board_WORD b; f(b); break; }
+    case 4:  { X_O_Inverse_Board b; f(b); break; }
+    case 5:  { Diamond_X_O_Board b; f(b); break; }
+    case 6:  { X_O_Board4 b; f(b); break; }
+    case 7:  { Pyramid_X_O_Board b; f(b); break; }
+    case 8:  { X_O_Num_Board b; f(b); break; }
+    case 9:  { obstacles_X_O_Board b; f(b); break; }
+    case 10: { X_O_Board b; f(b); break; }
+    case 11: { Ultimate_X_O_Board b; f(b); break; }
+    case 12: { Memo_X_O_Board b; f(b); break; }
+    }
+}
+
 #endif // XO_CLASSES_H
 
@@ -18,7 +18,6 @@
 
 #include "BoardGame_Classes.h"
 #include "XO_Classes.h"
-#include "dic.h"
 
 using namespace std;
 
@@ -53,8 +52,9 @@ void menu() {
  *  - Ensures proper cleanup after the game ends
  *
  * @param choice The users numerical game choice from the menu.
+ * @param rng Random generator for the board and computer players.
  */
-void run_game(int choice) {
+void run_game(int choice, GameRandom& rng) {
 
     UI<char>* game_ui = nullptr;
     Board<char>* board = nullptr;
@@ -80,6 +80,9 @@ void run_game(int choice) {
         return;
     }
 
+    board->set_random(&rng);
+    game_ui->set_random(&rng);
+
     // Set up players
     Player<char>** players = game_ui->setup_players();
 
@@ -102,7 +105,7 @@ void run_game(int choice) {
  */
 int main() {
 
-    srand(static_cast<unsigned int>(time(0))); // Seed RNG
+    GameRandom rng(static_cast<unsigned long long>(time(0))); // Seed RNG
 
     int choice;
     menu();
@@ -113,7 +116,7 @@ int main() {
         if (choice == 14)
             break;
 
-        run_game(choice);
+        run_game(choice, rng);
 
         cout << "Do you want to play again?\n"
              << "1) Yes\n"
@@ -0,0 +1,127 @@
+/**
+ * @file XO_Replay.cpp
+ * @brief Replays the games of a game log written by XO_Tournament.
+ *
+ * This file:
+ *  - Maps a log file (see BoardGame_Log.h) and walks its records
+ *  - Replays every game on a fresh board of its variant
+ *  - Checks that each replay ends on the logged result
+ *  - Prints per-variant counts, or the moves and final board of one game
+ *
+ * Usage:
+ * @code
+ * XO_Replay log_file [game_number]
+ * @endcode
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+#include "BoardGame_Classes.h"
+#include "XO_Classes.h"
+#include "BoardGame_Log.h"
+
+using namespace std;
+
+/**
+ * @brief Replays @p game on a fresh board of its variant.
+ *
+ * @param show Print every move and the final board.
+ * @return Result reached, -1 if the replay diverged from the log.
+ */
+int replay(const GameLogEntry& game, GameRandom& rng, bool show) {
+    const XO_Variant& variant = xo_variant(game.get_variant());
+    Player<char> first("Player 1", variant.symbols[0], PlayerType::COMPUTER);
+    Player<char> second("Player 2", variant.symbols[1], PlayerType::COMPUTER);
+    Player<char>* players[2] = { &first, &second };
+
+    int result = -1;
+    with_variant_board(game.get_variant(), [&](auto& board) {
+        result = replay_game(game, board, players, rng);
+        if (!show) return;
+
+        for (int i = 0; i < game.get_plies(); ++i) {
+            Move<char> move = game.get_move(i);
+            cout << setw(4) << i + 1 << ". " << move.get_symbol() << " (" << move.get_x()
+                 << ", " << move.get_y() << ")";
+            if (move.get_direction()) cout << " " << move.get_direction();
+            cout << "\n";
+        }
+        for (const vector<char>& row : board.get_board_matrix()) {
+            for (char cell : row)
+                cout << ' ' << cell;
+            cout << "\n";
+        }
+        });
+    return result;
+}
+
+/**
+ * @brief Main function. Replays the log and prints the counts.
+ *
+ * @return int 0 if every game replayed to its logged result, 1 otherwise.
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Usage: XO_Replay log_file [game_number]\n";
+        return 1;
+    }
+    GameLogReader log;
+    if (!log.open(argv[1])) {
+        cerr << "Cannot read game log " << argv[1] << "\n";
+        return 1;
+    }
+    long long wanted = argc > 2 ? atoll(argv[2]) : -1;
+    static const char* results[4] = { "cut off", "draw", "first player wins", "second player wins" };
+
+    long long games[XO_VARIANT_COUNT] = {}, diverged[XO_VARIANT_COUNT] = {};
+    long long index = 0, unknown = 0;
+    GameRandom rng;
+    auto start = chrono::steady_clock::now();
+    for (GameLogEntry game : log) {
+        if (wanted >= 0 && index++ != wanted)
+            continue;
+        if (game.get_variant() >= XO_VARIANT_COUNT) {
+            ++unknown;
+            continue;
+        }
+
+        bool show = wanted >= 0;
+        if (show)
+            cout << "Game " << wanted << ": " << xo_variant(game.get_variant()).name
+                 << ", seed " << game.get_seed() << ", " << game.get_plies() << " moves, "
+                 << results[game.get_result()] << "\n";
+        int result = replay(game, rng, show);
+        ++games[game.get_variant()];
+        if (result != game.get_result()) {
+            ++diverged[game.get_variant()];
+            if (show) cout << "Replay diverged from the log\n";
+        }
+        if (show) break;
+    }
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (wanted >= 0 && index <= wanted) {
+        cerr << "The log has only " << index << " games\n";
+        return 1;
+    }
+
+    long long all_games = 0, all_diverged = 0;
+    for (int v = 0; v < XO_VARIANT_COUNT; ++v) {
+        all_games += games[v];
+        all_diverged += diverged[v];
+    }
+    if (wanted < 0) {
+        cout << left << setw(24) << "Variant" << right << setw(12) << "Games" << setw(12) << "Diverged" << "\n";
+        for (int v = 0; v < XO_VARIANT_COUNT; ++v)
+            if (games[v])
+                cout << left << setw(24) << xo_variant(v).name << right
+                     << setw(12) << games[v] << setw(12) << diverged[v] << "\n";
+        cout << "\n" << all_games << " games replayed in " << fixed << setprecision(3) << elapsed
+             << " s, " << all_diverged << " diverged, " << unknown << " of unknown variants\n";
+    }
+    return all_diverged == 0 && unknown == 0 ? 0 : 1;
+}
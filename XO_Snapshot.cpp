@@ -0,0 +1,224 @@
+/**
+ * @file XO_Snapshot.cpp
+ * @brief Checks board snapshots (Board::save_to / restore_from) on every
+ *        X-O game variant.
+ *
+ * For each variant this file:
+ *  - Plays seeded random games and snapshots every position
+ *  - Restores each snapshot on a fresh board and checks that the cells,
+ *    move count, hash and snapshot bytes come back the same
+ *  - Feeds restore_from the snapshot cut short, with a trailing byte and
+ *    with each single bit flipped, and checks that it either refuses the
+ *    input and leaves the board as it was, or accepts a position that
+ *    saves back to the same bytes
+ *  - Checks that hand-made snapshots whose hidden state contradicts their
+ *    cells are refused
+ *
+ * Usage:
+ * @code
+ * XO_Snapshot [seed] [games]
+ * @endcode
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+
+#include "BoardGame_Classes.h"
+#include "XO_Classes.h"
+
+using namespace std;
+
+/// Largest snapshot of any variant, in bytes.
+const int SNAPSHOT_BYTES = 256;
+
+/**
+ * @brief Snapshot of @p board.
+ */
+vector<unsigned char> snapshot(const Board<char>& board) {
+    vector<unsigned char> bytes(SNAPSHOT_BYTES);
+    bytes.resize(board.save_to(Span<unsigned char>(bytes.data(), bytes.size())));
+    return bytes;
+}
+
+/**
+ * @brief Check whether @p a and @p b hold the same position.
+ */
+bool same_position(const Board<char>& a, const Board<char>& b) {
+    return a.get_board_matrix() == b.get_board_matrix() && a.get_n_moves() == b.get_n_moves() &&
+           a.get_hash() == b.get_hash() && a.position_index() == b.position_index() &&
+           snapshot(a) == snapshot(b);
+}
+
+/**
+ * @brief Feeds @p bytes to restore_from on @p board, which holds a valid
+ *        position.
+ *
+ * @return false if the input was refused but the board changed, or
+ *         accepted but does not save back to @p bytes.
+ */
+bool check_input(Board<char>& board, const vector<unsigned char>& bytes) {
+    vector<unsigned char> before = snapshot(board);
+    if (board.restore_from(Span<const unsigned char>(bytes.data(), bytes.size())))
+        return snapshot(board) == bytes;
+    return snapshot(board) == before;
+}
+
+/**
+ * @brief Checks the snapshots of @p games random games of variant @p v.
+ *
+ * @return Number of failed checks.
+ */
+long long check_variant(int v, unsigned long long seed, int games, long long& positions) {
+    const XO_Variant& info = xo_variant(v);
+    Player<char> first("Player 1", info.symbols[0], PlayerType::COMPUTER);
+    Player<char> second("Player 2", info.symbols[1], PlayerType::COMPUTER);
+    Player<char>* players[2] = { &first, &second };
+    GameRandom rng(seed + v);
+    unique_ptr<Board<char>> board;
+    unique_ptr<Board<char>> copy(info.create());
+    MoveList<char> moves;
+
+    long long failures = 0;
+    for (int g = 0; g < games; ++g) {
+        board.reset(info.create());
+        board->set_random(&rng);
+        for (int ply = 0;; ++ply) {
+            vector<unsigned char> bytes = snapshot(*board);
+            ++positions;
+            if (bytes.empty() || !copy->restore_from(Span<const unsigned char>(bytes.data(), bytes.size())) ||
+                !same_position(*board, *copy)) {
+                ++failures;
+                break;
+            }
+
+            vector<unsigned char> bad(bytes.begin(), bytes.end() - 1);
+            failures += !check_input(*copy, bad);
+            bad = bytes;
+            bad.push_back(0);
+            failures += !check_input(*copy, bad);
+            for (size_t bit = 0; bit < 8 * bytes.size(); ++bit) {
+                bad = bytes;
+                bad[bit / 8] ^= static_cast<unsigned char>(1 << (bit % 8));
+                failures += !check_input(*copy, bad);
+            }
+
+            Player<char>* player = players[ply % 2];
+            board->generate_moves(player, moves);
+            if (moves.empty() || !board->update_board(moves[rng.below(moves.size())]))
+                break;
+            if (board->game_is_over(player))
+                break;
+        }
+    }
+    return failures;
+}
+
+/**
+ * @brief Starts a snapshot of a 3x3 board with @p bits bits per cell,
+ *        after @p moves moves, all cells holding code 0 but those in
+ *        @p codes (nine codes, or nullptr).
+ */
+void write_cells(BitWriter& out, int bits, int moves, const int* codes) {
+    out.put(Board<char>::SNAPSHOT_VERSION, 8);
+    out.put(3, 8);
+    out.put(3, 8);
+    out.put(bits, 8);
+    out.put(moves, 16);
+    out.put(0, 16);
+    for (int i = 0; i < 9; ++i)
+        out.put(codes ? codes[i] : 0, bits);
+}
+
+/**
+ * @brief Check that @p board refuses the snapshot in @p out and is left
+ *        as it was.
+ */
+bool refused(Board<char>& board, const BitWriter& out, const unsigned char* bytes) {
+    vector<unsigned char> before = snapshot(board);
+    return !board.restore_from(Span<const unsigned char>(bytes, out.size())) && snapshot(board) == before;
+}
+
+/**
+ * @brief Feeds snapshots whose hidden state contradicts their cells to
+ *        the variants that keep hidden state.
+ *
+ * @return Number of snapshots that were not refused.
+ */
+int check_contradictions() {
+    unsigned char bytes[SNAPSHOT_BYTES];
+    int failures = 0;
+
+    {   // Infinity: empty board, a queue of seven copies of cell 0.
+        X_O_Board board;
+        BitWriter out(Span<unsigned char>(bytes, sizeof(bytes)));
+        write_cells(out, 2, 0, nullptr);
+        out.put(0, 3);
+        out.put(7, 3);
+        for (int k = 0; k < 7; ++k)
+            out.put(0, 4);
+        failures += !refused(board, out, bytes);
+    }
+    {   // Infinity: X on cell 4 but the queue names cell 0.
+        static const int codes[9] = { 0, 0, 0, 0, 1, 0, 0, 0, 0 };
+        X_O_Board board;
+        BitWriter out(Span<unsigned char>(bytes, sizeof(bytes)));
+        write_cells(out, 2, 1, codes);
+        out.put(0, 3);
+        out.put(1, 3);
+        out.put(0, 4);
+        failures += !refused(board, out, bytes);
+    }
+    {   // Memory: a hidden X on a cell the board shows empty.
+        Memo_X_O_Board board;
+        BitWriter out(Span<unsigned char>(bytes, sizeof(bytes)));
+        write_cells(out, 1, 1, nullptr);
+        out.put(1, 2);
+        for (int i = 1; i < 9; ++i)
+            out.put(0, 2);
+        failures += !refused(board, out, bytes);
+    }
+    {   // Numerical: digit 5 marked used on an empty board.
+        X_O_Num_Board board;
+        BitWriter out(Span<unsigned char>(bytes, sizeof(bytes)));
+        write_cells(out, 4, 0, nullptr);
+        out.put(1 << 5, 10);
+        failures += !refused(board, out, bytes);
+    }
+    {   // SUS: a line counted for the first player on an empty board.
+        SUS_Board board;
+        BitWriter out(Span<unsigned char>(bytes, sizeof(bytes)));
+        write_cells(out, 2, 0, nullptr);
+        out.put(1, 4);
+        out.put(0, 4);
+        out.put(1, 8);
+        failures += !refused(board, out, bytes);
+    }
+    return failures;
+}
+
+/**
+ * @brief Main function. Checks the snapshots of every variant.
+ *
+ * @return int 0 if every check passed, 1 otherwise.
+ */
+int main(int argc, char* argv[]) {
+    unsigned long long seed = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1;
+    int games = argc > 2 ? atoi(argv[2]) : 20;
+
+    cout << left << setw(24) << "Variant" << right << setw(12) << "positions" << setw(12) << "failures" << "\n";
+    long long total = 0;
+    for (int v = 0; v < XO_VARIANT_COUNT; ++v) {
+        long long positions = 0;
+        long long failures = check_variant(v, seed, games, positions);
+        cout << left << setw(24) << xo_variant(v).name << right << setw(12) << positions
+             << setw(12) << failures << "\n";
+        total += failures;
+    }
+    int contradictions = check_contradictions();
+    cout << "\n" << contradictions << " contradictory snapshots accepted\n";
+    return total || contradictions ? 1 : 0;
+}
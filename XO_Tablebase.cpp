@@ -0,0 +1,121 @@
+/**
+ * @file XO_Tablebase.cpp
+ * @brief Solves the small X-O variants outright and writes their tablebases.
+ *
+ * This file:
+ *  - Generates the tablebase of a variant with a perfect index (see
+ *    BoardGame_Tablebase.h) on several threads
+ *  - Writes it to a file, maps the file back and checks every entry
+ *  - Prints how many positions are won, lost and drawn, and the value
+ *    of the initial position
+ *
+ * Usage:
+ * @code
+ * XO_Tablebase variant_number file [threads]
+ * @endcode
+ * Variant numbers are those of xo_variant; without arguments the
+ * variants that can be solved are listed.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <type_traits>
+#include <chrono>
+#include <cstdlib>
+
+#include "BoardGame_Classes.h"
+#include "XO_Classes.h"
+#include "BoardGame_Tablebase.h"
+
+using namespace std;
+
+/**
+ * @brief Describes @p entry, the value for @p mover to move.
+ */
+string describe(const TBEntry& entry, const string& mover) {
+    switch (entry.result) {
+    case TB_WIN:  return mover + " wins in " + to_string(entry.distance) + " plies";
+    case TB_LOSS: return mover + " loses in " + to_string(entry.distance) + " plies";
+    case TB_DRAW: return "draw";
+    default:      return "not covered";
+    }
+}
+
+/**
+ * @brief Main function. Generates, writes and checks one tablebase.
+ *
+ * @return int 0 if the tablebase was written and reads back intact, 1 otherwise.
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Usage: XO_Tablebase variant_number file [threads]\n\nVariants with an index:\n";
+        for (int v = 0; v < XO_VARIANT_COUNT; ++v)
+            with_variant_board(v, [&](auto& board) {
+                if (board.position_count())
+                    cerr << setw(4) << v << "  " << left << setw(24) << xo_variant(v).name << right
+                         << setw(12) << board.position_count() << " positions\n";
+                });
+        return 1;
+    }
+    int v = atoi(argv[1]);
+    string path = argv[2];
+    int threads = argc > 3 ? atoi(argv[3]) : 0;
+    if (v < 0 || v >= XO_VARIANT_COUNT) {
+        cerr << "No variant " << argv[1] << "\n";
+        return 1;
+    }
+
+    const XO_Variant& variant = xo_variant(v);
+    Player<char> first("Player 1", variant.symbols[0], PlayerType::COMPUTER);
+    Player<char> second("Player 2", variant.symbols[1], PlayerType::COMPUTER);
+    Player<char>* players[2] = { &first, &second };
+
+    int status = 1;
+    with_variant_board(v, [&](auto& board) {
+        typedef typename decay<decltype(board)>::type BoardT;
+        if (!board.position_count()) {
+            cerr << variant.name << " has no position index\n";
+            return;
+        }
+
+        TablebaseGenerator<BoardT> generator(board, players, threads);
+        auto start = chrono::steady_clock::now();
+        if (!generator.generate()) {
+            cerr << "Generation failed: a distance exceeds " << TB_MAX_DISTANCE << " plies\n";
+            return;
+        }
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (!generator.save(path, variant.name)) {
+            cerr << "Cannot write " << path << "\n";
+            return;
+        }
+
+        Tablebase table;
+        if (!table.open(path) || !table.verify() || table.get_name() != variant.name || !table.covers(board)) {
+            cerr << "Cannot read back " << path << "\n";
+            return;
+        }
+        long long mismatched = 0;
+        for (long long i = 0; i < table.get_count(); ++i) {
+            TBEntry written = generator.get_entry(i), read = table.probe(i);
+            if (written.result != read.result || written.distance != read.distance)
+                ++mismatched;
+        }
+
+        cout << left << setw(20) << "Variant" << variant.name << "\n"
+             << setw(20) << "Positions" << table.get_count() << "\n"
+             << setw(20) << "Won" << generator.count_of(TB_WIN) << "\n"
+             << setw(20) << "Lost" << generator.count_of(TB_LOSS) << "\n"
+             << setw(20) << "Drawn" << generator.count_of(TB_DRAW) << "\n"
+             << setw(20) << "Not reachable" << generator.count_of(TB_NONE) << "\n"
+             << setw(20) << "Passes" << generator.get_passes() << "\n"
+             << setw(20) << "Longest distance" << table.get_max_distance() << " plies\n"
+             << setw(20) << "Initial position" << describe(table.probe(board), first.get_name()) << "\n"
+             << setw(20) << "Checksum" << hex << table.get_checksum() << dec << "\n"
+             << "\nSolved in " << fixed << setprecision(3) << elapsed << " s, "
+             << mismatched << " entries differ in the file\n";
+        status = mismatched == 0 ? 0 : 1;
+        });
+    return status;
+}
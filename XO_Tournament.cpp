@@ -0,0 +1,227 @@
+/**
+ * @file XO_Tournament.cpp
+ * @brief Multi-threaded self-play tournament over all X-O game variants.
+ *
+ * This file:
+ *  - Splits N games per variant into fixed-size tasks
+ *  - Hands the tasks to one worker thread per core
+ *  - Plays every game headless between two random computer players
+ *  - Prints win/draw/loss tallies and timings per variant
+ *  - Optionally prints per-phase turn metrics per variant
+ *  - Optionally appends every game to a game log (see BoardGame_Log.h)
+ *
+ * Usage:
+ * @code
+ * XO_Tournament [games_per_variant] [threads] [seed] [metrics] [log_file]
+ * @endcode
+ *
+ * Games are run by StaticGameManager on the concrete board class of each
+ * variant, so no board or agent call goes through a vtable. A non-zero
+ * @c metrics argument adds the TurnMetrics policy. Every ply is then kept
+ * in memory.
+ *
+ * Each game gets its own board, players and two GameRandoms, one for the
+ * board's random events and one for the agents. The game seed comes from
+ * (seed, variant, task, game), so the tallies are the same whatever the
+ * number of threads. The board's generator is seeded with the game seed
+ * itself, which is what the log stores, so XO_Replay can replay any
+ * logged game from its moves.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <type_traits>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <cstdlib>
+
+#include "BoardGame_Classes.h"
+#include "XO_Classes.h"
+#include "BoardGame_Metrics.h"
+#include "BoardGame_Log.h"
+
+using namespace std;
+
+/// Number of games played by one task.
+const int GAMES_PER_TASK = 256;
+
+/**
+ * @brief Results of a batch of games of one variant.
+ */
+struct Tally {
+    long long games = 0;       ///< Games played
+    long long wins[2] = {};    ///< Games won by the first and second player
+    long long draws = 0;       ///< Games that ended in a draw
+    long long cut_off = 0;     ///< Games stopped before their end
+    long long plies = 0;       ///< Moves played over all games
+    double seconds = 0;        ///< Thread time spent playing
+
+    /** @brief Add the results of @p other to this tally. */
+    void add(const Tally& other) {
+        games += other.games;
+        wins[0] += other.wins[0];
+        wins[1] += other.wins[1];
+        draws += other.draws;
+        cut_off += other.cut_off;
+        plies += other.plies;
+        seconds += other.seconds;
+    }
+};
+
+/**
+ * @brief A slice of games of one variant.
+ */
+struct Task {
+    int variant;   ///< Variant index (see xo_variant)
+    int index;     ///< Task number within the variant
+    int games;     ///< Number of games to play
+    Tally tally;   ///< Results, filled by the worker that ran the task
+    TurnMetrics metrics; ///< Turn metrics, if enabled
+    vector<unsigned char> log; ///< Encoded game records, if logging
+};
+
+/**
+ * @brief Plays all games of a task and records their results.
+ *
+ * @tparam Metrics StaticGameManager metrics policy; recorded metrics are
+ *         merged into the task.
+ * @param task Task to run.
+ * @param seed Tournament seed.
+ * @param logging Encode every game into @c task.log.
+ */
+template <typename Metrics>
+void play_task(Task& task, unsigned long long seed, bool logging) {
+    const XO_Variant& variant = xo_variant(task.variant);
+    unsigned long long task_seed = seed ^ (static_cast<unsigned long long>(task.variant) << 32) ^ task.index;
+    GameRandom rng;        // board events
+    GameRandom agent_rng;  // move choices
+    RandomAgent<char> agent(&agent_rng);
+    GameRecord<char> record;
+
+    auto start = chrono::steady_clock::now();
+    for (int g = 0; g < task.games; ++g) {
+        unsigned long long game_seed = splitmix64(task_seed);
+        rng.reseed(game_seed);
+        agent_rng.reseed(~game_seed);
+        Player<char> first("Player 1", variant.symbols[0], PlayerType::COMPUTER);
+        Player<char> second("Player 2", variant.symbols[1], PlayerType::COMPUTER);
+        Player<char>* players[2] = { &first, &second };
+
+        with_variant_board(task.variant, [&](auto& board) {
+            typedef typename decay<decltype(board)>::type BoardT;
+            board.set_random(&rng);
+            StaticGameManager<BoardT, RandomAgent<char>, RandomAgent<char>, Metrics>
+                game(board, players, agent, agent);
+            game.run(record);
+            if constexpr (Metrics::enabled)
+                task.metrics.merge(game.get_metrics());
+            });
+        if (logging)
+            encode_game(task.log, task.variant, game_seed, record);
+
+        task.tally.games++;
+        task.tally.plies += record.plies;
+        if (!record.finished)
+            task.tally.cut_off++;
+        else if (record.winner < 0)
+            task.tally.draws++;
+        else
+            task.tally.wins[record.winner]++;
+    }
+    task.tally.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Main function. Runs the tournament and prints the tallies.
+ *
+ * @return int 0 on success.
+ */
+int main(int argc, char* argv[]) {
+    long long games_per_variant = argc > 1 ? atoll(argv[1]) : 10000;
+    int n_threads = argc > 2 ? atoi(argv[2]) : static_cast<int>(thread::hardware_concurrency());
+    unsigned long long seed = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1;
+    bool with_metrics = argc > 4 && atoi(argv[4]) != 0;
+    const char* log_path = argc > 5 ? argv[5] : nullptr;
+    if (n_threads < 1) n_threads = 1;
+
+    GameLogWriter log;
+    if (log_path && !log.open(log_path)) {
+        cerr << "Cannot open game log " << log_path << "\n";
+        return 1;
+    }
+
+    vector<Task> tasks;
+    for (int v = 0; v < XO_VARIANT_COUNT; ++v)
+        for (long long first = 0, index = 0; first < games_per_variant; first += GAMES_PER_TASK, ++index) {
+            int games = static_cast<int>(min<long long>(GAMES_PER_TASK, games_per_variant - first));
+            tasks.push_back(Task{ v, static_cast<int>(index), games, Tally(), TurnMetrics(), {} });
+        }
+
+    // Workers pull tasks from a shared counter; everything else is per task
+    // except the log, which takes each task's records in one locked write.
+    atomic<size_t> next(0);
+    mutex log_lock;
+    auto worker = [&]() {
+        for (size_t t = next++; t < tasks.size(); t = next++) {
+            if (with_metrics)
+                play_task<TurnMetrics>(tasks[t], seed, log_path != nullptr);
+            else
+                play_task<NoMetrics>(tasks[t], seed, log_path != nullptr);
+            if (log_path) {
+                lock_guard<mutex> guard(log_lock);
+                log.write(tasks[t].log);
+                vector<unsigned char>().swap(tasks[t].log);
+            }
+        }
+        };
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (int i = 0; i < n_threads; ++i)
+        threads.emplace_back(worker);
+    for (thread& t : threads)
+        t.join();
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (log_path && !log.flush())
+        cerr << "Writing game log " << log_path << " failed\n";
+
+    Tally totals[XO_VARIANT_COUNT];
+    for (const Task& task : tasks)
+        totals[task.variant].add(task.tally);
+
+    cout << games_per_variant << " games per variant on " << n_threads
+         << " threads, seed " << seed << "\n\n";
+    cout << left << setw(24) << "Variant" << right
+         << setw(10) << "Games" << setw(10) << "P1 wins" << setw(10) << "P2 wins"
+         << setw(10) << "Draws" << setw(10) << "Cut off" << setw(10) << "Plies"
+         << setw(10) << "us/game" << "\n";
+
+    long long all_games = 0;
+    for (int v = 0; v < XO_VARIANT_COUNT; ++v) {
+        const Tally& t = totals[v];
+        all_games += t.games;
+        cout << left << setw(24) << xo_variant(v).name << right
+             << setw(10) << t.games << setw(10) << t.wins[0] << setw(10) << t.wins[1]
+             << setw(10) << t.draws << setw(10) << t.cut_off
+             << setw(10) << fixed << setprecision(1) << (t.games ? double(t.plies) / t.games : 0.0)
+             << setw(10) << setprecision(2) << (t.games ? t.seconds * 1e6 / t.games : 0.0) << "\n";
+    }
+
+    cout << "\n" << all_games << " games in " << setprecision(3) << elapsed << " s ("
+         << setprecision(0) << (elapsed > 0 ? all_games / elapsed : 0.0) << " games/s)\n";
+
+    if (with_metrics) {
+        TurnMetrics metrics[XO_VARIANT_COUNT];
+        for (const Task& task : tasks)
+            metrics[task.variant].merge(task.metrics);
+        for (int v = 0; v < XO_VARIANT_COUNT; ++v) {
+            cout << "\n" << xo_variant(v).name << "\n";
+            metrics[v].print_summary(cout);
+        }
+    }
+    return 0;
+}
@@ -3,8 +3,9 @@
  * @brief Dictionary of valid 3-letter English words for the Word Tic-Tac-Toe game.
  *
  * @details
- * This header defines a static `unordered_set<string>` named `s` that contains
- * all valid 3-letter words used in the "Word Tic-Tac-Toe" (X_O_Board_WORD).
+ * This header defines the function `dictionary()`, which returns the
+ * `unordered_set<string>` of all valid 3-letter words used in the
+ * "Word Tic-Tac-Toe" (X_O_Board_WORD).
  *
  * During gameplay, any row/column/diagonal that forms a 3-letter sequence is checked
  * against this dictionary. If the sequence exists in the set (in normal or reversed order),
@@ -12,7 +13,8 @@
  *
  * The dictionary is stored as:
  *  - **unordered_set** → for fast O(1) lookups
- *  - **static global** → so it is shared across all translation units that include this file
+ *  - **function-local static** → built once on first use (thread-safe) and
+ *    shared by every translation unit and thread
  *
  * This file contains **over 1000 valid English 3-letter words**, taken from a standard
  * word list. The dictionary supports both normal and reverse spellings (e.g. "CAT", "TAC").
@@ -25,19 +27,19 @@
 
 using namespace std;
 /**
- * @var s
- * @brief Global static dictionary of valid 3-letter words.
+ * @brief Dictionary of valid 3-letter words.
  *
  * @details
  * This unordered_set holds all accepted words for Word Tic-Tac-Toe.
  * The game logic performs:
- *  - direct lookup:   `s.find(word) != s.end()`
+ *  - direct lookup:   `dictionary().count(word)`
  *  - reverse lookup:  `reverse(word)` then search again
  *
- * Using a hash set ensures extremely fast membership tests.
+ * Using a hash set ensures extremely fast membership tests. The set is
+ * read-only, so any number of games may query it concurrently.
  */
-
-    static unordered_set<string> s = {
+inline const unordered_set<string>& dictionary() {
+    static const unordered_set<string> words = {
         "AAH", "AAL", "AAS", "ABA", "ABO", "ABS", "ABY", "ACE", "ACT", "ADD",
         "ADO", "ADS", "ADZ", "AFF", "AFT", "AGA", "AGE", "AGO", "AHA", "AID",
         "AIL", "AIM", "AIN", "AIR", "AIS", "AIT", "ALA", "ALB", "ALE", "ALL",
@@ -137,6 +139,8 @@ using namespace std;
         "ZAG", "ZAP", "ZAX", "ZED", "ZEE", "ZEK", "ZIG", "ZIN", "ZIP", "ZIT",
         "ZOA", "ZOO"
     };
+    return words;
+}
 
 
 #endif